@@ -0,0 +1,494 @@
+/*
+dynarr_bench.cpp - Benchmarks for dynarr.h against std::vector and std::deque
+
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring
+rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software.
+If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+/*
+building:
+    c++ -O2 -std=c++17 -I.. dynarr_bench.cpp -o dynarr_bench
+    any other dynarr options (e.g. -DDYNARR_SIZE_T or -DDYNARR_GROWTH=1.5) can be added to compare configurations
+
+usage:
+    dynarr_bench [max size] [max megabytes] [filter]
+    runs every operation for element sizes of 1 to 256 bytes and array sizes of 10 up to max size (defaults to 10000000),
+    skipping combinations whose array would take more than max megabytes (defaults to 1024), and only running operations
+    whose name contains filter if given. Results are written to stdout as CSV with a header line, one line per operation,
+    container, element size, and array size, so that runs before and after a change can be diffed or joined directly.
+
+operations:
+    push, push_n, push_front, pop, dequeue, insert_front, insert_mid, remove_front, remove_mid, insert_n, remove_range
+    shove_front, shove_mid, ditch_front, ditch_mid, ring_push, ring_churn, resize_churn, capacity_churn
+    find_lin, find_bin, sort_std, sort_ins, sort_radix (1, 2, 4, and 8 byte elements only)
+    insert and remove are O(n) per call so they only do a fixed number of calls, insert_n, remove_range and push_n move
+    blocks of 100 elements per call, sort_ins is O(n^2) so it sorts runs of at most 1000 elements one after another,
+    all other per-element operations touch every element once, times are averaged over enough repetitions to run for
+    at least a few milliseconds
+*/
+
+//includes
+#define DYNARR_STATIC
+#include "dynarr.h"
+#include <algorithm> //sort, lower_bound, find
+#include <chrono> //steady_clock
+#include <cstdio> //printf
+#include <cstdint> //uint64_t
+#include <cstring> //memcmp
+#include <deque> //deque
+#include <vector> //vector
+
+//element of given size, with its first bytes used as key
+template <int N> struct elem {
+    unsigned char b[N];
+    bool operator==(const elem& o) const { return !memcmp(b, o.b, N); }
+    bool operator<(const elem& o) const { return memcmp(b, o.b, N) < 0; }
+};
+
+//globals
+static volatile uint64_t sink;
+static const char* filter;
+static const int BATCH = 1000;
+static const int BLOCK = 100;
+static const long long INS_MAX = 1000;
+static const double MIN_NS = 5e6;
+
+//helpers
+template <int N> static elem<N> makeElem (uint64_t k) {
+    //spread key over the first bytes, most significant first so memcmp order matches key order
+    elem<N> e;
+    memset(e.b, 0, N);
+    for (int i = 0; (i < N)&&(i < 8); i++) e.b[i] = (unsigned char)(k >> 8*(((N < 8) ? N : 8)-1-i));
+    return e;
+}
+template <int N> static int compElem (const elem<N>* a, const elem<N>* b) {
+    return memcmp(a->b, b->b, N);
+}
+static uint64_t nextRand (uint64_t* s) {
+    //xorshift64
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+static double nowNs () {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static void report (const char* op, const char* cont, int bytes, long long size, long long ops, double ns) {
+    printf("%s,%s,%d,%lld,%lld,%.0f,%.3f\n", op, cont, bytes, size, ops, ns, ops ? ns/ops : 0.0);
+    fflush(stdout);
+}
+static int wanted (const char* op) {
+    return (!filter)||(strstr(op, filter));
+}
+
+//runs body repeatedly until enough time has passed, returns average nanoseconds per run
+template <typename F> static double timeRuns (F body, long long* runs) {
+    double total = 0;
+    *runs = 0;
+    do {
+        double t = nowNs();
+        body();
+        total += nowNs() - t;
+        (*runs)++;
+    } while (total < MIN_NS);
+    return total / *runs;
+}
+
+//benchmarks for one element size and array size
+template <int N> static void benchSize (long long n) {
+    typedef elem<N> T;
+    long long runs;
+    double ns;
+    //random keys shared by both containers
+    std::vector<T> keys((size_t)n);
+    uint64_t seed = 88172645463325252ull;
+    for (long long i = 0; i < n; i++) keys[(size_t)i] = makeElem<N>(nextRand(&seed));
+    //push
+    if (wanted("push")) {
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW(T);
+            for (long long i = 0; i < n; i++) DYNARR_PUSH(a, keys[(size_t)i]);
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report("push", "dynarr", N, n, n, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v;
+            for (long long i = 0; i < n; i++) v.push_back(keys[(size_t)i]);
+            sink = sink + v.size();
+        }, &runs);
+        report("push", "vector", N, n, n, ns);
+        ns = timeRuns([&]{
+            std::deque<T> d;
+            for (long long i = 0; i < n; i++) d.push_back(keys[(size_t)i]);
+            sink = sink + d.size();
+        }, &runs);
+        report("push", "deque", N, n, n, ns);
+    }
+    //push of blocks, growing at most once per block
+    if (wanted("push_n")) {
+        long long count = (n < BLOCK) ? n : BLOCK;
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW(T);
+            for (long long i = 0; i < n; i += count) {
+                T* p = DYNARR_PUSH_N(a, (DARRINT)count);
+                if (p) memcpy(p, &keys[(size_t)i], sizeof(T)*count);
+            }
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report("push_n", "dynarr", N, n, n/count, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v;
+            for (long long i = 0; i < n; i += count) v.insert(v.end(), keys.begin() + i, keys.begin() + i + count);
+            sink = sink + v.size();
+        }, &runs);
+        report("push_n", "vector", N, n, n/count, ns);
+    }
+    //push at the front, which vector has no counterpart for
+    if (wanted("push_front")) {
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW(T);
+            for (long long i = 0; i < n; i++) DYNARR_PUSH_FRONT(a, keys[(size_t)i]);
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report("push_front", "dynarr", N, n, n, ns);
+        ns = timeRuns([&]{
+            std::deque<T> d;
+            for (long long i = 0; i < n; i++) d.push_front(keys[(size_t)i]);
+            sink = sink + d.size();
+        }, &runs);
+        report("push_front", "deque", N, n, n, ns);
+    }
+    //pop and dequeue, timing only the removals
+    if ((wanted("pop"))||(wanted("dequeue"))) {
+        for (int deq = 0; deq < 2; deq++) {
+            const char* op = deq ? "dequeue" : "pop";
+            if (!wanted(op)) continue;
+            double total = 0;
+            runs = 0;
+            do {
+                T* a = DYNARR_NEW_EX(T, (DARRINT)n);
+                DYNARR_APPEND(a, keys.data(), (DARRINT)n);
+                double t = nowNs();
+                uint64_t s = 0;
+                if (deq) for (long long i = 0; i < n; i++) s += DYNARR_DEQUEUE(a).b[0];
+                else for (long long i = 0; i < n; i++) s += DYNARR_POP(a).b[0];
+                total += nowNs() - t;
+                sink = sink + s;
+                DYNARR_FREE(a);
+                runs++;
+            } while (total < MIN_NS);
+            report(op, "dynarr", N, n, n, total/runs);
+            total = 0;
+            runs = 0;
+            do {
+                std::vector<T> v(keys);
+                std::deque<T> d(keys.begin(), keys.end());
+                double t = nowNs();
+                uint64_t s = 0;
+                if (deq) for (long long i = 0; i < n; i++) { s += d.front().b[0]; d.pop_front(); }
+                else for (long long i = 0; i < n; i++) { s += v.back().b[0]; v.pop_back(); }
+                total += nowNs() - t;
+                sink = sink + s;
+                runs++;
+            } while (total < MIN_NS);
+            report(op, deq ? "deque" : "vector", N, n, n, total/runs);
+        }
+    }
+    //insert and remove at front and middle, a fixed batch of calls on an array of size n
+    const char* ops[4] = {"insert_front", "insert_mid", "remove_front", "remove_mid"};
+    for (int o = 0; o < 4; o++) {
+        if (!wanted(ops[o])) continue;
+        int ins = (o < 2), mid = (o & 1);
+        long long calls = ins ? BATCH : ((n < BATCH) ? n : BATCH);
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW_EX(T, (DARRINT)(n+BATCH));
+            DYNARR_APPEND(a, keys.data(), (DARRINT)n);
+            for (long long i = 0; i < calls; i++) {
+                DARRINT at = mid ? DYNARR_SIZE(a)/2 : 0;
+                if (ins) {
+                    if (!DYNARR_SIZE(a)) DYNARR_PUSH(a, keys[0]);
+                    else DYNARR_INSERT(a, at, keys[(size_t)(i % n)]);
+                } else {
+                    DYNARR_REMOVE(a, at);
+                }
+            }
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report(ops[o], "dynarr", N, n, calls, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v(keys);
+            for (long long i = 0; i < calls; i++) {
+                size_t at = mid ? v.size()/2 : 0;
+                if (ins) v.insert(v.begin() + at, keys[(size_t)(i % n)]);
+                else v.erase(v.begin() + at);
+            }
+            sink = sink + v.size();
+        }, &runs);
+        report(ops[o], "vector", N, n, calls, ns);
+        ns = timeRuns([&]{
+            std::deque<T> d(keys.begin(), keys.end());
+            for (long long i = 0; i < calls; i++) {
+                size_t at = mid ? d.size()/2 : 0;
+                if (ins) d.insert(d.begin() + at, keys[(size_t)(i % n)]);
+                else d.erase(d.begin() + at);
+            }
+            sink = sink + d.size();
+        }, &runs);
+        report(ops[o], "deque", N, n, calls, ns);
+    }
+    //unordered insert and remove at front and middle, once per element on an array of size n
+    const char* uops[4] = {"shove_front", "shove_mid", "ditch_front", "ditch_mid"};
+    for (int o = 0; o < 4; o++) {
+        if (!wanted(uops[o])) continue;
+        int ins = (o < 2), mid = (o & 1);
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW_EX(T, (DARRINT)(2*n));
+            DYNARR_APPEND(a, keys.data(), (DARRINT)n);
+            for (long long i = 0; i < n; i++) {
+                DARRINT at = mid ? DYNARR_SIZE(a)/2 : 0;
+                if (ins) DYNARR_SHOVE(a, at, keys[(size_t)i]);
+                else DYNARR_DITCH(a, at);
+            }
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report(uops[o], "dynarr", N, n, n, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v(keys);
+            for (long long i = 0; i < n; i++) {
+                size_t at = mid ? v.size()/2 : 0;
+                if (ins) {
+                    v.push_back(v[at]);
+                    v[at] = keys[(size_t)i];
+                } else {
+                    v[at] = v.back();
+                    v.pop_back();
+                }
+            }
+            sink = sink + v.size();
+        }, &runs);
+        report(uops[o], "vector", N, n, n, ns);
+    }
+    //block insert and remove in the middle, a fixed batch of calls on an array of size n
+    const char* bops[2] = {"insert_n", "remove_range"};
+    for (int o = 0; o < 2; o++) {
+        if (!wanted(bops[o])) continue;
+        int ins = !o;
+        long long count = (n < BLOCK) ? n : BLOCK, calls = ins ? BATCH/10 : ((n/count < BATCH/10) ? n/count : BATCH/10);
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW_EX(T, (DARRINT)(n + count*calls));
+            DYNARR_APPEND(a, keys.data(), (DARRINT)n);
+            for (long long i = 0; i < calls; i++) {
+                if (ins) DYNARR_INSERT_N(a, DYNARR_SIZE(a)/2, keys.data(), (DARRINT)count);
+                else DYNARR_REMOVE_RANGE(a, (DYNARR_SIZE(a)-(DARRINT)count)/2, (DARRINT)count);
+            }
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report(bops[o], "dynarr", N, n, calls, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v(keys);
+            for (long long i = 0; i < calls; i++) {
+                if (ins) v.insert(v.begin() + v.size()/2, keys.begin(), keys.begin() + count);
+                else v.erase(v.begin() + (v.size()-count)/2, v.begin() + (v.size()-count)/2 + count);
+            }
+            sink = sink + v.size();
+        }, &runs);
+        report(bops[o], "vector", N, n, calls, ns);
+        ns = timeRuns([&]{
+            std::deque<T> d(keys.begin(), keys.end());
+            for (long long i = 0; i < calls; i++) {
+                if (ins) d.insert(d.begin() + d.size()/2, keys.begin(), keys.begin() + count);
+                else d.erase(d.begin() + (d.size()-count)/2, d.begin() + (d.size()-count)/2 + count);
+            }
+            sink = sink + d.size();
+        }, &runs);
+        report(bops[o], "deque", N, n, calls, ns);
+    }
+    //ring buffer push from empty
+    if (wanted("ring_push")) {
+        ns = timeRuns([&]{
+            T* a = DYNARR_RING_NEW(T, 1);
+            for (long long i = 0; i < n; i++) DYNARR_RING_PUSH(a, keys[(size_t)i]);
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report("ring_push", "ring", N, n, n, ns);
+        ns = timeRuns([&]{
+            std::deque<T> d;
+            for (long long i = 0; i < n; i++) d.push_back(keys[(size_t)i]);
+            sink = sink + d.size();
+        }, &runs);
+        report("ring_push", "deque", N, n, n, ns);
+    }
+    //queue churn, dequeuing and pushing once per element on a queue holding n elements, timing only the churn
+    if (wanted("ring_churn")) {
+        for (int c = 0; c < 3; c++) {
+            double total = 0;
+            runs = 0;
+            do {
+                T* a = c ? NULL : DYNARR_RING_NEW(T, (DARRINT)n);
+                T* b = (c == 1) ? DYNARR_NEW_EX(T, (DARRINT)n) : NULL;
+                std::deque<T> d;
+                if (a) for (long long i = 0; i < n; i++) DYNARR_RING_PUSH(a, keys[(size_t)i]);
+                if (b) DYNARR_APPEND(b, keys.data(), (DARRINT)n);
+                if (c == 2) d.assign(keys.begin(), keys.end());
+                double t = nowNs();
+                uint64_t s = 0;
+                if (a) for (long long i = 0; i < n; i++) { s += DYNARR_RING_DEQUEUE(a).b[0]; DYNARR_RING_PUSH(a, keys[(size_t)i]); }
+                if (b) for (long long i = 0; i < n; i++) { s += DYNARR_DEQUEUE(b).b[0]; DYNARR_PUSH(b, keys[(size_t)i]); }
+                if (c == 2) for (long long i = 0; i < n; i++) { s += d.front().b[0]; d.pop_front(); d.push_back(keys[(size_t)i]); }
+                total += nowNs() - t;
+                sink = sink + s;
+                if (a) DYNARR_FREE(a);
+                if (b) DYNARR_FREE(b);
+                runs++;
+            } while (total < MIN_NS);
+            const char* cont[3] = {"ring", "dynarr", "deque"};
+            report("ring_churn", cont[c], N, n, n, total/runs);
+        }
+    }
+    //resize churn, alternating between full and a tenth of the size
+    if (wanted("resize_churn")) {
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW(T);
+            for (int i = 0; i < 10; i++) {
+                DYNARR_RESIZE(a, (DARRINT)n);
+                DYNARR_RESIZE(a, (DARRINT)(n/10));
+            }
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report("resize_churn", "dynarr", N, n, 20, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v;
+            for (int i = 0; i < 10; i++) {
+                v.resize((size_t)n);
+                v.resize((size_t)(n/10));
+            }
+            sink = sink + v.size();
+        }, &runs);
+        report("resize_churn", "vector", N, n, 20, ns);
+    }
+    //capacity churn, reserving the full size and then shrinking to fit a tenth of it
+    if (wanted("capacity_churn")) {
+        ns = timeRuns([&]{
+            T* a = DYNARR_NEW(T);
+            DYNARR_APPEND(a, keys.data(), (DARRINT)(n/10));
+            for (int i = 0; i < 10; i++) {
+                DYNARR_CAPACITY(a, (DARRINT)n);
+                DYNARR_SHRINK_TO_FIT(a);
+            }
+            sink = sink + DYNARR_SIZE(a);
+            DYNARR_FREE(a);
+        }, &runs);
+        report("capacity_churn", "dynarr", N, n, 20, ns);
+        ns = timeRuns([&]{
+            std::vector<T> v(keys.begin(), keys.begin() + n/10);
+            for (int i = 0; i < 10; i++) {
+                v.reserve((size_t)n);
+                v.shrink_to_fit();
+            }
+            sink = sink + v.size();
+        }, &runs);
+        report("capacity_churn", "vector", N, n, 20, ns);
+    }
+    //linear find of the last element, so the whole array is scanned
+    if (wanted("find_lin")) {
+        T* a = DYNARR_NEW_EX(T, (DARRINT)n);
+        DYNARR_APPEND(a, keys.data(), (DARRINT)n);
+        T k = keys[(size_t)(n-1)];
+        ns = timeRuns([&]{ sink = sink + DYNARR_FIND_LIN(a, &k); }, &runs);
+        report("find_lin", "dynarr", N, n, n, ns);
+        ns = timeRuns([&]{ sink = sink + (std::find(keys.begin(), keys.end(), k) - keys.begin()); }, &runs);
+        report("find_lin", "vector", N, n, n, ns);
+        DYNARR_FREE(a);
+    }
+    //binary find of a batch of random keys in a sorted array
+    if (wanted("find_bin")) {
+        std::vector<T> sorted(keys);
+        std::sort(sorted.begin(), sorted.end());
+        T* a = DYNARR_NEW_EX(T, (DARRINT)n);
+        DYNARR_APPEND(a, sorted.data(), (DARRINT)n);
+        ns = timeRuns([&]{
+            uint64_t s = 0;
+            for (int i = 0; i < BATCH; i++) s += DYNARR_FIND_BIN(a, compElem<N>, &keys[(size_t)(i % n)]);
+            sink = sink + s;
+        }, &runs);
+        report("find_bin", "dynarr", N, n, BATCH, ns);
+        ns = timeRuns([&]{
+            uint64_t s = 0;
+            for (int i = 0; i < BATCH; i++) s += std::lower_bound(sorted.begin(), sorted.end(), keys[(size_t)(i % n)]) - sorted.begin();
+            sink = sink + s;
+        }, &runs);
+        report("find_bin", "vector", N, n, BATCH, ns);
+        DYNARR_FREE(a);
+    }
+    //sorts of the same random keys in runs of up to m elements, timing only the sorts themselves
+    const char* sops[3] = {"sort_std", "sort_ins", "sort_radix"};
+    for (int o = 0; o < 3; o++) {
+        int radix = (o == 2);
+        if ((!wanted(sops[o]))||((radix)&&(N != 1)&&(N != 2)&&(N != 4)&&(N != 8))) continue;
+        long long m = ((o == 1)&&(n > INS_MAX)) ? INS_MAX : n;
+        double total = 0;
+        runs = 0;
+        do {
+            T* a = DYNARR_NEW_EX(T, (DARRINT)m);
+            for (long long r = 0; r < n; r += m) {
+                DYNARR_CLEAR(a);
+                DYNARR_APPEND(a, &keys[(size_t)r], (DARRINT)m);
+                double t = nowNs();
+                if (radix) DYNARR_SORT_RADIX(a, DYNARR_RADIX_UINT);
+                else if (o == 1) DYNARR_SORT_INS(a, compElem<N>);
+                else DYNARR_SORT_STD(a, compElem<N>);
+                total += nowNs() - t;
+                sink = sink + a[0].b[0];
+            }
+            DYNARR_FREE(a);
+            runs++;
+        } while (total < MIN_NS);
+        report(sops[o], "dynarr", N, n, n, total/runs);
+        total = 0;
+        runs = 0;
+        do {
+            for (long long r = 0; r < n; r += m) {
+                std::vector<T> v(keys.begin() + r, keys.begin() + r + m);
+                double t = nowNs();
+                std::sort(v.begin(), v.end());
+                total += nowNs() - t;
+                sink = sink + v[0].b[0];
+            }
+            runs++;
+        } while (total < MIN_NS);
+        report(sops[o], "vector", N, n, n, total/runs);
+    }
+}
+
+//runs all array sizes for one element size
+template <int N> static void benchElem (long long maxn, long long maxmb) {
+    for (long long n = 10; n <= maxn; n *= 10) {
+        if ((double)n*N > (double)maxmb*1024*1024) break;
+        benchSize<N>(n);
+    }
+}
+
+int main (int argc, char** argv) {
+    long long maxn = (argc > 1) ? atoll(argv[1]) : 10000000, maxmb = (argc > 2) ? atoll(argv[2]) : 1024;
+    filter = (argc > 3) ? argv[3] : NULL;
+    printf("op,container,elem_bytes,size,ops,ns_total,ns_per_op\n");
+    benchElem<1>(maxn, maxmb);
+    benchElem<2>(maxn, maxmb);
+    benchElem<4>(maxn, maxmb);
+    benchElem<8>(maxn, maxmb);
+    benchElem<16>(maxn, maxmb);
+    benchElem<64>(maxn, maxmb);
+    benchElem<256>(maxn, maxmb);
+    return 0;
+}
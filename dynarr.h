@@ -19,12 +19,43 @@ dynarr supports the following three configurations:
 dynarr supports the following additional options:
 #define DYNARR_NO_ASSERT
     Disables the use of assert in various dynarr functions, must be defined globally to work properly.
+#define DYNARR_SIZE_T
+    Uses ptrdiff_t instead of int for all sizes, capacities, and indices, must be defined globally to work properly.
+    Allows a dynarr to grow beyond 2GB, all types documented as "int" below then refer to ptrdiff_t instead.
+#define DYNARR_AUTO_SHRINK F
+    Makes DYNARR_POP, DYNARR_DEQUEUE, DYNARR_REMOVE, DYNARR_DITCH, and DYNARR_RESIZE release memory once size drops below
+    1/F of capacity, by shrinking capacity to F/2 times size. F should be at least twice DYNARR_GROWTH, so that a dynarr
+    has to grow or shrink by a large factor after each shrink before capacity changes again. DYNARR_CLEAR keeps its
+    capacity, so that clearing and refilling a dynarr does not reallocate. Must be defined globally.
+#define DYNARR_ATOMIC
+    Enables the lock-free concurrent queues and copy-on-write snapshots documented below, which require a C11 compiler
+    with <stdatomic.h> support or a C++11 compiler, and makes the totals of DYNARR_STATS process-wide. Must be defined
+    globally, as snapshots keep a reference count in every dynarr header.
+#define DYNARR_CACHE_LINE L
+    Overrides the cache line size used to keep the ends of concurrent queues apart. Defaults to 64.
+#define DYNARR_THREADS
+    Enables the pthreads backend for the parallel functions documented below, which requires linking with -pthread.
+#define DYNARR_MAX_THREADS T
+    Limits the number of threads parallel functions split their work for, which sizes their buffers on the stack. Defaults to 64.
+#define DYNARR_MMAP
+    Enables the file-backed dynarrs and huge page allocator documented below, which require a POSIX system with mmap and ftruncate. Strict ISO C
+    modes also need _POSIX_C_SOURCE (or _GNU_SOURCE, which enables mremap on Linux) to be defined before any includes.
+#define DYNARR_STATS
+    Enables the instrumentation counters and reallocation hook documented below, which enlarge the header of every dynarr.
+    Must be defined globally, and file-backed dynarrs must be reopened by builds with the same setting.
 #define DYNARR_ZALLOC(S)
     Overrides the zalloc function used by dynarr with your own. This is calloc but with just 1 argument.
 #define DYNARR_REALLOC(P, S)
     Overrides the realloc function used by dynarr with your own. Defaults to the standard realloc.
 #define DYNARR_FFREE(P)
     Overrides the free function used by dynarr with your own. Defaults to the standard free.
+#define DYNARR_GROWTH F
+    Overrides the factor by which capacity is multiplied when a dynarr needs to grow. Defaults to 2.
+    Smaller factors such as 1.5 waste less memory and allow the allocator to reuse freed blocks.
+#define DYNARR_MIN_CAPACITY C
+    Overrides the minimum capacity a dynarr has after creation or growth. Defaults to 1.
+#define DYNARR_MAX_GROWTH B
+    Limits the number of bytes by which a single growth may increase capacity. Defaults to 0 (unlimited).
 
 dynarr usage:
     A dynarr is a dynamic array of any one type with a multi-purpose interface, thus allowing it to act as just a dynamic array,
@@ -35,10 +66,12 @@ dynarr usage:
 dynarr initialization:
     A dynarr containing elements of a given type is represented as a pointer to said type that is initialized using DYNARR_NEW(type).
     Once initialized, it can be used as an argument in the various DYNARR_XXX macros. After use it should be freed using DYNARR_FREE.
+    If the number of elements is roughly known in advance, DYNARR_NEW_EX(type, int) preallocates capacity to avoid early growth.
 
 dynarr arguments:
     Due to them being macros, many DYNARR_XXX macros will end up evaluating their arguments multiple times. Arguments with
     side effects should therefore be avoided. An exception are value arguments (type "any"), which are evaluated exactly once.
+    The functions generated by DYNARR_DEFINE for a given type have no such caveat, as they are plain functions.
 */
 
 //header section
@@ -52,10 +85,36 @@ dynarr arguments:
 #else //DYNARR_EXTERN
     #define DARRDEF extern
 #endif
+#ifdef DYNARR_SIZE_T
+    #include <stddef.h> //ptrdiff_t
+    #include <stdint.h> //PTRDIFF_MAX
+    #define DARRINT ptrdiff_t
+    #define DARR_IMAX PTRDIFF_MAX
+#else
+    #include <limits.h> //INT_MAX
+    #define DARRINT int
+    #define DARR_IMAX INT_MAX
+#endif
 
 /*
 any* DYNARR_NEW(type)
     creates a new dynarr instance for given type and returns it, or NULL on failure
+any* DYNARR_NEW_EX(type, int)
+    same as DYNARR_NEW but with the given initial capacity instead of DYNARR_MIN_CAPACITY
+any* DYNARR_NEW_ALIGNED(type, int)
+    same as DYNARR_NEW but the first element is aligned to the given power of two, kept across reallocations
+any* DYNARR_NEW_ALLOC(type, struct dynarralloc*)
+    same as DYNARR_NEW but all memory of the dynarr is managed by the given allocator, see dynarr allocators below
+any* DYNARR_NEW_INLINE(type, void*, size_t)
+    same as DYNARR_NEW but places the dynarr inside the given buffer of given size in bytes instead of allocating it
+    the dynarr only moves to the heap once it outgrows the buffer, which must outlive it, NULL if buffer is too small
+    the first element is aligned to 16 bytes, types needing more have to use DYNARR_NEW_INLINE_ALIGNED
+any* DYNARR_NEW_INLINE_ALIGNED(type, int, void*, size_t)
+    same as DYNARR_NEW_INLINE but the first element is aligned to the given power of two, kept once on the heap
+size_t DYNARR_INLINE_SIZE(type, int)
+    returns the buffer size in bytes needed for DYNARR_NEW_INLINE to hold the given number of elements, constant expression
+size_t DYNARR_INLINE_SIZE_ALIGNED(type, int, int)
+    same as DYNARR_INLINE_SIZE but for DYNARR_NEW_INLINE_ALIGNED with the given alignment and number of elements
 int DYNARR_SIZE(any*)
     returns the size of the given dynarr, O(1)
 any DYNARR_AT(any*, int)
@@ -73,17 +132,40 @@ void DYNARR_FREE(any*)
 int DYNARR_PUSH(any*, any)
     appends the given element to the end of given dynarr (growing if needed), amortized O(1)
     returns the index the element was placed at, or -1 on allocation failure
+int DYNARR_APPEND(any*, any*, int)
+    appends the given number of elements read from given pointer to the end of given dynarr, growing at most once, O(n)
+    returns the index the first element was placed at, or -1 on allocation failure
+any* DYNARR_PUSH_N(any*, int)
+    appends the given number of uninitialized elements to the end of given dynarr, growing at most once, amortized O(1)
+    returns a pointer to the first appended element, valid until the next reallocation, or NULL on allocation failure
+int DYNARR_RESERVE(any*, int)
+    ensures there is space for at least the given number of additional elements at the end of given dynarr, O(n)
+    returns 0 on success, or -1 on allocation failure
 any DYNARR_POP(any*)
     removes the last element in given dynarr and returns it, must not be empty, O(1)
 any DYNARR_DEQUEUE(any*)
     removes the first element in given dynarr and returns it, must not be empty, O(1)
+int DYNARR_PUSH_FRONT(any*, any)
+    prepends the given element to the front of given dynarr, using the space left in front by the offset, amortized O(1)
+    if there is none the elements are re-centered so both ends have room, growing first if less than half their size
+    would be left free, returns the index the element was placed at (always 0), or -1 on allocation failure
+any DYNARR_POP_FRONT(any*)
+    same as DYNARR_DEQUEUE, the counterpart of DYNARR_PUSH_FRONT for using a dynarr as a double-ended queue, O(1)
 int DYNARR_INSERT(any*, int, any)
     inserts the given element at given index in given dynarr, shifting other elements forward, O(n)
+    elements in front of the index are shifted back into the offset instead if there are fewer of them and room for it
     returns the index the element was placed at, or -1 on allocation failure
+int DYNARR_INSERT_N(any*, int, any*, int)
+    same as DYNARR_INSERT but inserts the given number of elements read from given pointer, which may be NULL to leave them
+    uninitialized, the elements are shifted and capacity is grown at most once, O(n+k)
+    index may also equal the size to append, pointer must not point into the dynarr itself
 int DYNARR_SHOVE(any*, int, any)
     faster alternative to DYNARR_INSERT that doesn't maintain order of other elements, amortized O(1)
 void DYNARR_REMOVE(any*, int)
     removes the element at given index in given dynarr while maintaining order of remaining elements, O(n)
+    whichever of the elements in front of or behind the index are fewer are shifted, the former by growing the offset
+void DYNARR_REMOVE_RANGE(any*, int, int)
+    same as DYNARR_REMOVE but removes the given number of elements starting at given index, shifting just once, O(n)
 void DYNARR_DITCH(any*, int)
     faster alternative to DYNARR_REMOVE that doesn't maintain order of remaining elements, O(1)
 int DYNARR_RESIZE(any*, int)
@@ -92,17 +174,415 @@ int DYNARR_RESIZE(any*, int)
 int DYNARR_CAPACITY(any*, int)
     adjusts the internal capacity of the given dynarr to most closely match the given number of elements, O(n)
     returns the capacity after resizing, may not match what was requested, or -1 on allocation failure
+int DYNARR_SHRINK_TO_FIT(any*)
+    reduces the capacity of given dynarr to its size, does nothing if it already matches, O(n)
+    returns the capacity after resizing, or -1 on allocation failure
+for DYNARR_FOREACH(type, any*, name)
+    loops over all elements in given dynarr of given type, with name declared as a pointer to the current element
+    the start and end of the elements are only read once before the loop, so the dynarr must not grow or shrink inside it
+void DYNARR_MAP(any*, void(*)(any*, void*), void*)
+    calls given function on every element in given dynarr in order, passing given context pointer along, O(n)
+    the function may modify the element through the given pointer, but must not grow or shrink the dynarr
+void DYNARR_REDUCE(any*, void(*)(void*, const any*, void*), void*, void*)
+    folds all elements in given dynarr into the accumulator pointed to by the third argument, in order, O(n)
+    the function is called as function(accumulator, element, context) and must combine the element into the accumulator
+int DYNARR_FILTER(any*, int(*)(const any*, void*), void*)
+    removes all elements for which given function returns 0 when passed the element and given context pointer, O(n)
+    the remaining elements keep their order and are moved at most once, returns the number of elements kept
 int DYNARR_FIND_LIN(any*, any*)
     returns the index of the first element equal to the value pointed to by given key, -1 if not found, O(n)
+    1, 2, 4, and 8 byte elements are compared directly as integers rather than through memcmp
 int DYNARR_FIND_BIN(any*, int(*)(const void*, const any*), void*)
     returns the index of an element that evaluates as equal to given key according to given function, O(logn)
     dynarr must be sorted in ascending order beforehand, otherwise result is undefined, -1 if not found
+    function is called with the key as first argument, if there are multiple equal elements the first is returned
+int DYNARR_LOWER_BOUND(any*, int(*)(const void*, const any*), void*)
+    returns the index of the first element not less than given key according to given function, O(logn)
+    dynarr must be sorted as for DYNARR_FIND_BIN, returns the size of the dynarr if all elements are less than key
+int DYNARR_UPPER_BOUND(any*, int(*)(const void*, const any*), void*)
+    same as DYNARR_LOWER_BOUND but returns the index of the first element greater than given key instead, O(logn)
+int DYNARR_EQUAL_RANGE(any*, int(*)(const void*, const any*), void*, int*)
+    returns the lower bound of given key and stores its upper bound in the given pointer, O(logn)
+    all elements equal to key are in the range from lower (inclusive) to upper (exclusive), which is empty if none are
+int DYNARR_MERGE(any*, any*, any*, int(*)(const any*, const any*))
+    replaces the contents of the first dynarr with all elements of the other two, which must be sorted according to given
+    function and are merged into a sorted result, taking from the second dynarr first among equal elements, O(n+m)
+    the first dynarr must be a different one of the same type, and is reserved once for the largest possible result
+    returns the size of the result, or -1 on allocation failure, the same goes for the other set operations below
+int DYNARR_UNION(any*, any*, any*, int(*)(const any*, const any*))
+    same as DYNARR_MERGE but elements equal to one in the second dynarr are only taken from it, O(n+m)
+int DYNARR_INTERSECT(any*, any*, any*, int(*)(const any*, const any*))
+    same as DYNARR_MERGE but only takes elements of the second dynarr that have an equal one in the third, O(n+m)
+    if either is much smaller, each of its elements is found in the other by exponential search, O(n*log(m/n))
+int DYNARR_DIFFERENCE(any*, any*, any*, int(*)(const any*, const any*))
+    same as DYNARR_MERGE but only takes elements of the second dynarr that have no equal one in the third, O(n+m)
+    duplicates are treated as in a multiset, e.g. two equal elements in the second dynarr and one in the third leave one
+    in the result of DYNARR_DIFFERENCE and DYNARR_UNION, and one in the result of DYNARR_INTERSECT
+int DYNARR_UNIQUE(any*, int(*)(const any*, const any*))
+    removes all but the first of each run of equal elements in given sorted dynarr, keeping their order, O(n)
+    function may be NULL to compare bytes instead, which works for runs of identical elements in any dynarr
+    returns the new size of the dynarr
+void DYNARR_DEFINE_FIND(type, name)
+    defines "static int nameFindLinear(const type*, type)" and "static int nameFindBinary(const type*, type)"
+    which are the same as DYNARR_FIND_LIN and DYNARR_FIND_BIN for a dynarr of given type but take the key by value
+    and compare using == and <, so type must be an arithmetic or pointer type, should be used at file scope
+    the linear search scans in branch-free blocks the compiler can vectorize, the binary search is branch-free
+void DYNARR_DEFINE_SET(type, name)
+    defines "static int nameMerge(type**, const type*, const type*)" as well as nameUnion, nameIntersect, and
+    nameDifference with the same signature, and "static int nameUnique(type**)", which are the same as DYNARR_MERGE,
+    DYNARR_UNION, DYNARR_INTERSECT, DYNARR_DIFFERENCE, and DYNARR_UNIQUE for a dynarr of given type but compare using <
+    so type must be an arithmetic or pointer type, should be used at file scope, the merge loops are branch-free
+int DYNARR_INSERT_SORTED(any*, int(*)(const any*, const any*), any)
+    inserts the given element into given sorted dynarr after any equal elements so that it remains sorted, O(n)
+    dynarr must be sorted according to given comparison function, returns the index the element was placed at, or -1
 void DYNARR_SORT_INS(any*, int(*)(const any*, const any*))
-    insertion sorts the elements in given dynarr according to given comparison function, O(n*n)
+    binary insertion sorts the elements in given dynarr according to given comparison function, O(n*n)
+    elements are only moved when out of order, so already (nearly) sorted dynarrs take close to O(n), sort is stable
     comparison function should return 1 if first argument is greater than second argument
     0 if it is equal, and -1 if it is smaller, dynarr will be sorted smallest to greatest
 void DYNARR_SORT_STD(any*, int(*)(const any*, const any*))
-    same as DYNARR_SORT_INS but uses the C standard qsort function for sorting instead, O(n*logn)
+    same as DYNARR_SORT_INS but uses introsort (quicksort falling back to heapsort) instead, O(n*logn)
+    swaps of 4, 8, and 16 byte elements are specialized, sort is not stable
+int DYNARR_SORT_RADIX(any*, int)
+    LSD radix sorts the elements in given dynarr, which must be 1, 2, 4, or 8 byte integers or 4 or 8 byte floats, O(n)
+    key type is given as DYNARR_RADIX_UINT, DYNARR_RADIX_INT, or DYNARR_RADIX_FLOAT, sorts smallest to greatest
+    negative zero sorts before positive zero and NaNs sort to either end depending on their sign bit
+    returns 0 on success, or -1 on allocation failure of the temporary buffer (dynarr is then left unchanged)
+void DYNARR_DEFINE_SORT(type, name, comparison)
+    defines "static void nameSort(type*)", which introsorts a dynarr of given type using given comparison function or macro
+    comparison is called as comparison(const type*, const type*) and follows the same convention as DYNARR_SORT_INS
+    as it's called directly rather than through a function pointer, the compiler is free to inline it, should be used at file scope
+void DYNARR_DEFINE(type, name)
+    defines a set of "static inline" functions for a dynarr of given type, with its size known at compile time so that
+    element accesses and copies compile down to plain loads and stores, should be used at file scope
+    unlike the macros, these evaluate every argument exactly once, and functions that may reallocate take a type**
+    "type* nameNew(void)", "type* nameNewEx(int)", "void nameFree(type*)", "int nameSize(const type*)", "void nameClear(type*)"
+    "type* nameAt(type*, int)", "type nameGet(const type*, int)", "void nameSet(type*, int, type)", "type* nameData(type*)"
+    "int namePush(type**, type)", "type namePop(type**)", "type nameDequeue(type**)", "int namePushFront(type**, type)"
+    "type namePopFront(type**)", "int nameAppend(type**, const type*, int)"
+    "int nameInsert(type**, int, type)", "void nameRemove(type**, int)", "void nameDitch(type**, int)", "int nameReserve(type**, int)"
+    "int nameResize(type**, int)", and "int nameFind(const type*, type)", each the same as the matching DYNARR_XXX macro
+    nameData returns a pointer to the first element and nameFind compares whole elements bytewise using memcmp
+    can be combined with DYNARR_DEFINE_SORT and DYNARR_DEFINE_FIND for the same type and name
+*/
+
+/*
+dynarr parallelism:
+    Parallel functions split their work into tasks that are handed to an executor, a struct dynarrexec whose function is
+    called as run(executor, task, argument, count). It must call task(argument, i) exactly once for every i from 0 to count-1,
+    from any threads and in any order, and only return once all calls have returned, so any thread pool can back it. Its
+    threads field gives the number of tasks worth running at once, which parallel functions use to size their tasks, up to
+    DYNARR_MAX_THREADS. A NULL executor, or a threads field below 2, makes parallel functions run serially on the calling thread.
+void dynarrExecThreads(struct dynarrexec*, int) (requires DYNARR_THREADS)
+    initializes given executor to run tasks on the given number of threads, counting the calling thread, using pthreads
+    threads are created for each run, so the executor holds no resources, 0 or less uses the number of online processors
+void DYNARR_SORT_PAR(any*, int(*)(const any*, const any*), struct dynarrexec*)
+    same as DYNARR_SORT_STD but sorts chunks in parallel using given executor and then merges them in parallel, O(n*logn)
+    merges split each pair of runs by output position, so all threads stay busy until the end, sort is not stable
+    needs a temporary buffer as large as the dynarr, if that can't be allocated it falls back to DYNARR_SORT_STD
+int DYNARR_FIND_PAR(any*, any*, struct dynarrexec*)
+    same as DYNARR_FIND_LIN but scans chunks in parallel using given executor, O(n)
+    scans in rounds of doubling size and stops after the first round with a match, so early matches are found quickly
+void DYNARR_MAP_PAR(any*, void(*)(any*, void*), void*, struct dynarrexec*)
+    same as DYNARR_MAP but calls the function on chunks of elements in parallel, so it must be safe to call concurrently
+void DYNARR_REDUCE_PAR(any*, void(*)(void*, const any*, void*), void(*)(void*, const void*, void*), void*, void*, struct dynarrexec*)
+    same as DYNARR_REDUCE but folds chunks in parallel into copies of the accumulator, which must initially hold the
+    identity, that are then merged into it in chunk order by calling join(accumulator, partial accumulator, context)
+    the copies live in a heap buffer aligned like the accumulator, if it can't be allocated all chunks are folded serially
+int DYNARR_FILTER_PAR(any*, int(*)(const any*, void*), void*, struct dynarrexec*)
+    same as DYNARR_FILTER but compacts chunks in parallel, so the function must be safe to call concurrently
+    kept chunks are then moved together on the calling thread, which is a single memmove per chunk
+*/
+
+/*
+dynarr statistics:
+    With DYNARR_STATS defined, the header of every dynarr holds a struct dynarrstats, whose counters are also summed up
+    across all dynarrs. With DYNARR_ATOMIC also defined the totals are process-wide and updated with relaxed atomics,
+    otherwise they are kept per thread, as there is no portable way to share them. Without DYNARR_STATS none of this
+    exists and nothing is counted, so it costs nothing when disabled.
+    reallocs    number of reallocations, including the first move of borrowed storage to the heap
+    compacted   bytes copied while moving elements within the allocation to make space at either end
+    moved       bytes shifted by DYNARR_INSERT, DYNARR_INSERT_N, DYNARR_REMOVE, and DYNARR_REMOVE_RANGE
+    compares    comparator calls made by sorts, binary searches, and set operations, but not by the typed functions of
+                DYNARR_DEFINE_SORT and DYNARR_DEFINE_SET, calls made on other threads by DYNARR_SORT_PAR are counted
+                as if made by the calling thread, DYNARR_FIND_BIN, DYNARR_LOWER_BOUND, and DYNARR_UPPER_BOUND only
+                count towards the totals since they don't modify the dynarr and may run on one shared between threads
+    peak        largest allocation in bytes, for the totals the largest allocation of any dynarr
+    tag         caller tag, the "file:line" of the DYNARR_NEW_XXX, DYNARR_RING_NEW, DYNARR_LOAD, or DYNARR_MAP_OPEN that
+                created the dynarr, NULL for dynarrs created in other ways
+const struct dynarrstats* DYNARR_STATS_GET(any*) (requires DYNARR_STATS)
+    returns the counters of given dynarr, which are kept across reallocations, O(1)
+const struct dynarrstats* DYNARR_STATS_TOTAL() (requires DYNARR_STATS)
+    returns the counters summed up over all dynarrs, whose tag is always NULL, O(1)
+    with DYNARR_ATOMIC these are the totals of all threads, copied into a snapshot that is overwritten by the next call
+    on the same thread, otherwise they only cover dynarrs used by the calling thread
+void DYNARR_STATS_TAG(any*, const char*) (requires DYNARR_STATS)
+    replaces the caller tag of given dynarr with given string, which must outlive the dynarr, O(1)
+void DYNARR_STATS_HOOK(void(*)(const any*, size_t, size_t, const char*)) (requires DYNARR_STATS)
+    sets a function called as hook(dynarr, old bytes, new bytes, tag) after every reallocation and just before every free,
+    which passes 0 as new bytes, NULL removes it, shared by all threads so it should be set before they use dynarrs
+*/
+
+/*
+dynarr allocators:
+    By default all dynarrs use DYNARR_ZALLOC, DYNARR_REALLOC, and DYNARR_FFREE. A dynarr created with DYNARR_NEW_ALLOC instead
+    stores a pointer to the given allocator in its header and routes all of its (re)allocations through it, so different
+    groups of dynarrs can use different memory. An allocator is a struct dynarralloc, usually embedded as the first member
+    of a larger struct holding its state, whose function is called as func(allocator, pointer, old size, new size). It
+    allocates if pointer is NULL, frees and returns NULL if new size is 0, and reallocates otherwise. Allocators must outlive
+    all dynarrs using them, and the built-in ones below are not thread-safe.
+void dynarrArenaInit(struct dynarrarena*, void*, size_t)
+    initializes given arena to bump allocate from the given buffer of given size, which it does not take ownership of
+    growing the most recent allocation happens in place, freeing anything but the most recent allocation does nothing
+void dynarrArenaReset(struct dynarrarena*)
+    frees everything allocated from given arena at once, any dynarrs using it must no longer be used afterwards, O(1)
+void dynarrPoolInit(struct dynarrpool*)
+    initializes given pool, which serves sizes up to 64KB from free lists of power of two size classes
+    memory is taken from DYNARR_REALLOC in slabs, larger sizes are passed straight through to DYNARR_REALLOC
+void dynarrPoolDestroy(struct dynarrpool*)
+    frees all slabs owned by given pool, dynarrs using it must no longer be used, but those over 64KB must still be freed
+void dynarrHugeInit(struct dynarrhuge*, size_t, int, unsigned long) (requires DYNARR_MMAP)
+    initializes given allocator to serve sizes from the given number of bytes up from anonymous mmap in whole 2MB units
+    (1GB with DYNARR_HUGE_1GB) advised to use transparent huge pages, smaller sizes are passed through to DYNARR_REALLOC
+    flags can combine DYNARR_HUGE_2MB or DYNARR_HUGE_1GB to use explicitly reserved huge pages of that size when available,
+    and DYNARR_HUGE_INTERLEAVE to interleave pages across the given NUMA nodes rather than bind them to those nodes
+    nodes is a bit mask of NUMA nodes, one bit per node up to the width of unsigned long, or 0 to leave placement to the
+    system, which otherwise places pages on the node that first touches them
+    huge pages and NUMA placement are best effort, and silently fall back to normal pages and placement if unavailable
+    holds no state besides its settings, so unlike the other built-in allocators it is thread-safe and needs no cleanup
+*/
+
+/*
+dynarr file mapping (requires DYNARR_MMAP):
+    A dynarr opened using DYNARR_MAP_OPEN lives in a file that is mapped into memory with mmap, header included, so that
+    its contents persist across runs without any explicit reading or writing. Opening an existing file is O(1) regardless
+    of its size, as elements are only paged in once they are accessed. Growth and shrinking resize the file through
+    ftruncate and remap it, using mremap where available, and DYNARR_FREE unmaps the file and closes it, leaving its
+    contents in place. A mapped dynarr can be used with all other macros except DYNARR_RING_XXX. Files are only valid for
+    the element size and DYNARR_SIZE_T setting they were created with, and elements must not contain pointers.
+any* DYNARR_MAP_OPEN(type, struct dynarrmap*, const char*)
+    opens the file at given path as a dynarr of given type, creating an empty one if it doesn't exist yet
+    given struct dynarrmap holds the file and mapping, and must outlive the dynarr, which is the only one allowed to use it
+    returns NULL if the file can't be opened or mapped, or holds a dynarr of a different element size
+int DYNARR_MAP_SYNC(any*)
+    writes all changes to given mapped dynarr back to its file and waits for them to complete
+    returns 0 on success, or -1 on failure
+*/
+
+/*
+dynarr serialization:
+    A dynarr can be written to and read from a stable binary format, made up of a 256 byte header followed by the raw bytes
+    of its elements. The header starts with the magic bytes "DARR", followed by a 16 bit version, 16 bit flags, 32 bit
+    element size, 32 bit alignment, 64 bit element count, and 64 bit FNV-1a checksum of the element bytes, all in native
+    byte order, with the remaining bytes reserved. Files are rejected if written with a newer version or different byte
+    order. Elements are copied straight between the dynarr and the stream, and a buffer that already holds the format
+    can be wrapped as a dynarr without copying at all, since the reserved bytes leave room for a dynarr header in place.
+    Version 1 files, whose header is only 128 bytes, are still read.
+int DYNARR_SAVE(any*, FILE*, int)
+    writes the header and elements of given dynarr to given stream, O(n)
+    flags can be DYNARR_WIRE_CHECKSUM to store a checksum, which costs an extra pass over the elements
+    returns 0 on success, or -1 on write failure
+any* DYNARR_LOAD(type, FILE*)
+    reads a dynarr of given type from given stream, restoring its alignment, the checksum is verified if stored, O(n)
+    returns the new dynarr, or NULL on read or allocation failure, invalid header, size mismatch, or checksum mismatch
+const any* DYNARR_VIEW(type, void*, size_t)
+    wraps the serialized dynarr in given buffer of given size as a read-only dynarr of given type, O(1) without checksum
+    overwrites reserved header bytes only, the buffer must stay alive while in use and be aligned to 16 bytes or to the
+    stored alignment if larger
+    a view must not be modified or freed, returns NULL if the buffer is invalid for the same reasons as DYNARR_LOAD, or
+    if it holds a version 1 header with too few reserved bytes for the dynarr header of the current configuration
+size_t DYNARR_WIRE_SIZE(any*)
+    returns the number of bytes DYNARR_SAVE writes for given dynarr, O(1)
+*/
+
+/*
+dynarr struct of arrays:
+    A struct dynarrsoa holds several columns of elements, each of its own type, that share a single size, capacity, and
+    offset, so that rows are pushed, removed, and resized in all columns at once. All columns live in one allocation and
+    grow together with a single reallocation, each column contiguous and aligned to 64 bytes so that loops over it
+    vectorize well. Columns are accessed as plain arrays through DYNARR_SOA_COL, whose result is only valid until the
+    next reallocation, and rows are indexed from 0 like dynarr elements. The macros below are the only way to use one.
+struct dynarrsoa* DYNARR_SOA_NEW(int, size_t*, int)
+    creates a new struct of arrays with the given number of columns, whose element sizes are read from given array
+    and with the given initial capacity, returns NULL on failure
+any* DYNARR_SOA_COL(type, struct dynarrsoa*, int)
+    returns a pointer to the element in row 0 of the given column, which must hold elements of given type, O(1)
+int DYNARR_SOA_SIZE(struct dynarrsoa*)
+    returns the number of rows in given struct of arrays, O(1)
+int DYNARR_SOA_PUSH(struct dynarrsoa*)
+    appends an uninitialized row to given struct of arrays, growing all columns at once if needed, amortized O(1)
+    returns the index of the new row, or -1 on allocation failure
+void DYNARR_SOA_POP(struct dynarrsoa*)
+    removes the last row in given struct of arrays, must not be empty, O(1)
+void DYNARR_SOA_DEQUEUE(struct dynarrsoa*)
+    removes the first row in given struct of arrays, must not be empty, O(1)
+void DYNARR_SOA_DITCH(struct dynarrsoa*, int)
+    removes the row at given index by moving the last row into its place in every column, O(1)
+int DYNARR_SOA_RESERVE(struct dynarrsoa*, int)
+    ensures there is space for at least the given number of additional rows, O(n)
+    returns 0 on success, or -1 on allocation failure
+int DYNARR_SOA_RESIZE(struct dynarrsoa*, int)
+    resizes given struct of arrays to the given number of rows, new rows are zeroed in all columns, O(n)
+    returns the new size, or -1 on allocation failure
+void DYNARR_SOA_CLEAR(struct dynarrsoa*)
+    removes all rows from given struct of arrays, O(1)
+void DYNARR_SOA_FREE(struct dynarrsoa*)
+    frees given struct of arrays and all its columns
+*/
+
+/*
+dynarr slot maps:
+    A struct dynarrslotmap stores elements densely in a dynarr, so they can be iterated without holes, while handing out
+    64 bit handles that stay valid until the element they refer to is removed. Removal swaps the last element into the
+    gap like DYNARR_DITCH, and a slot array indexed by handle keeps track of where each element currently lives. Each slot
+    has a generation that is increased on removal, so stale handles to removed or reused slots are detected rather than
+    resolving to the wrong element. Handle 0 is never valid, so it can be used as a null handle. The dense array is a
+    regular dynarr that can be read and modified in place, but must only grow or shrink through the slot map.
+int DYNARR_SLOTMAP_INIT(type, struct dynarrslotmap*)
+    initializes given slot map for elements of given type, returns 0 on success, or -1 on allocation failure
+uint64_t DYNARR_SLOTMAP_INSERT(struct dynarrslotmap*, any*)
+    copies the element pointed to by given pointer into given slot map, amortized O(1)
+    returns the handle of the new element, or 0 on allocation failure
+int DYNARR_SLOTMAP_REMOVE(struct dynarrslotmap*, uint64_t)
+    removes the element with given handle from given slot map, moving the last element into its place, O(1)
+    returns 0 on success, or -1 if the handle is not valid (anymore)
+any* DYNARR_SLOTMAP_GET(type, struct dynarrslotmap*, uint64_t)
+    returns a pointer to the element with given handle, valid until the next insertion or removal, or NULL if invalid, O(1)
+any* DYNARR_SLOTMAP_DENSE(type, struct dynarrslotmap*)
+    returns the dense dynarr holding all elements in given slot map, which can be used with DYNARR_FOREACH and the like
+int DYNARR_SLOTMAP_SIZE(struct dynarrslotmap*)
+    returns the number of elements in given slot map, O(1)
+uint64_t DYNARR_SLOTMAP_HANDLE(struct dynarrslotmap*, int)
+    returns the handle of the element at given index in the dense dynarr, O(1)
+void DYNARR_SLOTMAP_FREE(struct dynarrslotmap*)
+    frees all internal data of given slot map, which can be initialized again afterwards
+*/
+
+/*
+dynarr segmented arrays:
+    A struct dynarrseg stores elements in separately allocated chunks of a fixed power of two number of elements, found
+    through a dynarr of chunk pointers. Growing only ever adds a chunk, so elements never move and pointers to them stay
+    valid until they are removed, and no reallocation ever copies more than the chunk pointers, which avoids the latency
+    spikes and transient memory peaks of growing a very large dynarr. Indexing is a shift and a mask on top of a dynarr
+    access. Chunks are freed from the front as their elements are dequeued, which suits append-only logs and large queues.
+int DYNARR_SEG_INIT(type, struct dynarrseg*, int)
+    initializes given segmented array for elements of given type, with chunks of given number of elements rounded up to a
+    power of two, or about 64KB if 0 or less, returns 0 on success, or -1 on allocation failure
+int DYNARR_SEG_SIZE(struct dynarrseg*)
+    returns the number of elements in given segmented array, O(1)
+any DYNARR_SEG_AT(type, struct dynarrseg*, int)
+    returns the element at given index in given segmented array, works as lvalue, O(1)
+int DYNARR_SEG_PUSH(type, struct dynarrseg*, any)
+    appends the given element to the end of given segmented array, adding a chunk if the last one is full, O(1)
+    returns the index the element was placed at, or -1 on allocation failure
+any DYNARR_SEG_POP(type, struct dynarrseg*)
+    removes the last element in given segmented array and returns it, must not be empty, its chunk is kept, O(1)
+any DYNARR_SEG_DEQUEUE(type, struct dynarrseg*)
+    removes the first element in given segmented array and returns it, must not be empty, O(1)
+    once all elements of the first chunk have been dequeued, that chunk is freed by the next dequeue
+int DYNARR_SEG_RESERVE(struct dynarrseg*, int)
+    adds chunks for at least the given number of additional elements, returns 0 on success, or -1 on allocation failure
+void DYNARR_SEG_SHRINK(struct dynarrseg*)
+    frees all chunks of given segmented array that hold no elements, O(chunks)
+void DYNARR_SEG_CLEAR(struct dynarrseg*)
+    clears given segmented array, setting its size to 0 but keeping its chunks, O(1)
+void DYNARR_SEG_FREE(struct dynarrseg*)
+    frees all chunks and internal data of given segmented array, which can be initialized again afterwards
+*/
+
+/*
+dynarr hash indices:
+    A struct dynarrhash is an optional companion to a dynarr that maps keys to element indices through a Robin Hood
+    hash table, making lookups O(1) on average without keeping the dynarr sorted. It stores indices and cached hashes only,
+    calling the given hash function on elements and the given comparison function, which returns 0 for equal elements
+    like those used for sorting, on a lookup key and candidate elements. The index has to be told about every change to
+    the dynarr, which the DYNARR_HASH_XXX macros below do alongside the matching DYNARR_XXX macro. After any other change,
+    such as sorting, modifying keys in place, or DYNARR_INSERT, it must be rebuilt in one pass using DYNARR_HASH_BUILD.
+void DYNARR_HASH_INIT(struct dynarrhash*, size_t(*)(const any*), int(*)(const any*, const any*))
+    initializes given hash index with given hash and comparison functions, it starts out empty without allocating
+int DYNARR_HASH_BUILD(any*, struct dynarrhash*)
+    clears given hash index and adds all elements of given dynarr to it, O(n)
+    returns 0 on success, or -1 on allocation failure, after which the index is empty
+int DYNARR_HASH_FIND(any*, struct dynarrhash*, any*)
+    returns the index of an element equal to the key pointed to by the last argument, or -1 if there is none, O(1)
+    if there are multiple equal elements, which is allowed, any one of them may be returned
+int DYNARR_HASH_PUSH(any*, struct dynarrhash*, any)
+    same as DYNARR_PUSH but also adds the new element to given hash index, amortized O(1)
+    returns the index the element was placed at, or -1 on allocation failure, in which case nothing is added
+any DYNARR_HASH_POP(any*, struct dynarrhash*)
+    same as DYNARR_POP but also removes the element from given hash index, O(1)
+void DYNARR_HASH_DITCH(any*, struct dynarrhash*, int)
+    same as DYNARR_DITCH but also updates given hash index for both the removed and moved element, O(1)
+void DYNARR_HASH_REMOVE(any*, struct dynarrhash*, int)
+    same as DYNARR_REMOVE but also updates given hash index, which requires renumbering all entries after it, O(n)
+void DYNARR_HASH_FREE(struct dynarrhash*)
+    frees the table of given hash index, which can be built again afterwards
+*/
+
+/*
+dynarr ring buffers:
+    A dynarr created using DYNARR_RING_NEW acts as a circular buffer whose elements wrap around the end of its storage,
+    making it a queue that never has to move elements to reclaim space freed by DYNARR_RING_DEQUEUE. Its capacity is always
+    a power of two and only grows once it is completely full. A ring dynarr must only be used with the DYNARR_RING_XXX macros
+    plus DYNARR_SIZE, DYNARR_VALID, DYNARR_CLEAR, and DYNARR_FREE, as all other macros assume that elements do not wrap.
+any* DYNARR_RING_NEW(type, int)
+    creates a new ring dynarr for given type with capacity for at least the given number of elements, or NULL on failure
+any DYNARR_RING_AT(any*, int)
+    returns the element at given index in given ring dynarr, works as lvalue, O(1)
+int DYNARR_RING_PUSH(any*, any)
+    appends the given element to the end of given ring dynarr (growing if full), amortized O(1)
+    returns the index the element was placed at, or -1 on allocation failure
+any DYNARR_RING_POP(any*)
+    removes the last element in given ring dynarr and returns it, must not be empty, O(1)
+any DYNARR_RING_DEQUEUE(any*)
+    removes the first element in given ring dynarr and returns it, must not be empty, O(1)
+*/
+
+/*
+dynarr concurrent queues (requires DYNARR_ATOMIC):
+    A concurrent queue is a fixed-capacity ring of elements laid out like a dynarr, with its header kept in front of the
+    elements, but with head and tail kept as atomics on separate cache lines so that both ends can be used from different
+    threads without any locks. SPSC queues allow exactly one producer and one consumer thread and are wait-free, while
+    MPMC queues allow any number of either and are lock-free. Elements are copied in and out through pointers, and
+    elements in the queue must not be accessed directly. Concurrent queues only work with the macros below.
+any* DYNARR_SPSC_NEW(type, int)
+    creates a new SPSC queue for given type with capacity for at least the given number of elements, or NULL on failure
+any* DYNARR_MPMC_NEW(type, int)
+    creates a new MPMC queue for given type with capacity for at least the given number of elements, or NULL on failure
+int DYNARR_SPSC_PUSH(any*, any*)
+    copies the element pointed to by given pointer to the end of given SPSC queue, wait-free O(1)
+    returns 0 on success, or -1 if the queue is full
+int DYNARR_SPSC_DEQUEUE(any*, any*)
+    removes the first element in given SPSC queue and copies it to given pointer, wait-free O(1)
+    returns 0 on success, or -1 if the queue is empty
+int DYNARR_MPMC_PUSH(any*, any*)
+    same as DYNARR_SPSC_PUSH but for MPMC queues, lock-free O(1)
+int DYNARR_MPMC_DEQUEUE(any*, any*)
+    same as DYNARR_SPSC_DEQUEUE but for MPMC queues, lock-free O(1)
+int DYNARR_QUEUE_SIZE(any*)
+    returns the number of elements in given queue, only a snapshot if other threads are using it, O(1)
+void DYNARR_QUEUE_FREE(any*)
+    frees given queue and all its internal data, must not be in use by any other thread
+*/
+
+/*
+dynarr snapshots (requires DYNARR_ATOMIC):
+    A snapshot is an immutable view of a dynarr that can be read from other threads while the writer keeps modifying
+    the dynarr, without copying anything up front. Taking one just adds a reference to the dynarr's current storage. Before
+    modifying a dynarr that snapshots may have been taken of, the writer calls DYNARR_UNSHARE, which copies the elements to
+    new storage only while snapshots are live and otherwise does nothing, so a dynarr without readers is still modified in
+    place. Storage is freed once the writer and all snapshots have let go of it, whichever comes last. Snapshots are taken
+    by threads that already hold the dynarr or a snapshot of it, usually the writer, and handed to readers, for example
+    through a concurrent queue. Dynarrs with an allocator can only be shared if the allocator is thread-safe, since storage
+    may be freed by whichever thread lets go of it last, and file-backed dynarrs can't be shared at all.
+const any* DYNARR_SNAPSHOT(type, any*)
+    takes a snapshot of given dynarr or snapshot, which can be read like a dynarr but must never be modified, O(1)
+void DYNARR_RELEASE(const any*)
+    lets go of given snapshot, freeing its storage if the writer and all other snapshots have already let go of it
+int DYNARR_UNSHARE(any*)
+    ensures given dynarr is no longer shared with any snapshot, copying its elements if any are live, O(1) or O(n)
+    must be called before modifying a dynarr that snapshots may have been taken of, returns 0 on success, or -1 on failure
+    DYNARR_FREE only lets go of the storage of a dynarr, it is actually freed once all of its snapshots are released
 */
 
 //macros
@@ -112,7 +592,14 @@ void DYNARR_SORT_STD(any*, int(*)(const any*, const any*))
 #else
     #define DARR_ASSERT(E) ((void)0)
 #endif
-#define DYNARR_NEW(T) ((T*)dynarrNew(sizeof(T)))
+#define DYNARR_NEW(T) ((T*)DARR_TAG(dynarrNew(sizeof(T))))
+#define DYNARR_NEW_EX(T, C) ((T*)DARR_TAG(dynarrNewEx(sizeof(T), C, 0, NULL)))
+#define DYNARR_NEW_ALIGNED(T, L) ((T*)DARR_TAG(dynarrNewEx(sizeof(T), DYNARR_MIN_CAPACITY, L, NULL)))
+#define DYNARR_NEW_ALLOC(T, L) ((T*)DARR_TAG(dynarrNewEx(sizeof(T), DYNARR_MIN_CAPACITY, 0, L)))
+#define DYNARR_NEW_INLINE(T, B, S) ((T*)DARR_TAG(dynarrNewInline(sizeof(T), 0, B, S)))
+#define DYNARR_NEW_INLINE_ALIGNED(T, L, B, S) ((T*)DARR_TAG(dynarrNewInline(sizeof(T), L, B, S)))
+#define DYNARR_INLINE_SIZE(T, N) DYNARR_INLINE_SIZE_ALIGNED(T, 0, N)
+#define DYNARR_INLINE_SIZE_ALIGNED(T, L, N) (DARR_HEAD + (((L) > 16) ? (size_t)(L) : 16) - 1 + sizeof(T)*(N))
 #define DYNARR_SIZE(A) (DARR_SIZE(A))
 #define DYNARR_AT(A, I) (*(DARR_ASSERT(DYNARR_VALID(A, I)), &(A)[DARR_OFFS(A)+(I)]))
 #define DYNARR_FIRST(A) (*(DARR_ASSERT(DARR_SIZE(A)), &(A)[DARR_OFFS(A)]))
@@ -121,20 +608,335 @@ void DYNARR_SORT_STD(any*, int(*)(const any*, const any*))
 #define DYNARR_CLEAR(A) (DARR_OFFS(A) = DARR_SIZE(A) = 0, (void)0)
 #define DYNARR_FREE(A) dynarrFree(A)
 #define DYNARR_PUSH(A, V) (dynarrGrow((void**)&(A)) ? -1 : ((A)[DARR_OFFS(A)+DARR_SIZE(A)] = V, DARR_SIZE(A)++))
-#define DYNARR_POP(A) (DARR_ASSERT(DARR_SIZE(A)), (A)[DARR_OFFS(A)+--DARR_SIZE(A)])
-#define DYNARR_DEQUEUE(A) (DARR_ASSERT(DARR_SIZE(A)), DARR_SIZE(A)--, (A)[DARR_OFFS(A)++])
-#define DYNARR_INSERT(A, I, V) (DARR_ASSERT(DYNARR_VALID(A, I)), dynarrGrow((void**)&(A)) ? -1 : \
-    (memmove(&(A)[DARR_OFFS(A)+(I)+1], &(A)[DARR_OFFS(A)+(I)], DARR_ELEM(A)*(DARR_SIZE(A)-(I))), (A)[DARR_OFFS(A)+(I)] = V, DARR_SIZE(A)++, I))
+#define DYNARR_APPEND(A, P, N) dynarrAppend((void**)&(A), P, N)
+#define DYNARR_PUSH_N(A, N) (dynarrReserve((void**)&(A), N) ? NULL : (DARR_SIZE(A) += (N), &(A)[DARR_OFFS(A)+DARR_SIZE(A)-(N)]))
+#define DYNARR_RESERVE(A, N) dynarrReserve((void**)&(A), N)
+#define DYNARR_POP(A) (DARR_ASSERT(DARR_SIZE(A)), DARR_TRIM(A), (A)[DARR_OFFS(A)+--DARR_SIZE(A)])
+#define DYNARR_DEQUEUE(A) (DARR_ASSERT(DARR_SIZE(A)), DARR_TRIM(A), DARR_SIZE(A)--, (A)[DARR_OFFS(A)++])
+#define DYNARR_PUSH_FRONT(A, V) (dynarrGrowFront((void**)&(A)) ? -1 : ((A)[--DARR_OFFS(A)] = V, DARR_SIZE(A)++, 0))
+#define DYNARR_POP_FRONT(A) DYNARR_DEQUEUE(A)
+#define DYNARR_INSERT(A, I, V) (DARR_ASSERT(DYNARR_VALID(A, I)), \
+    (dynarrInsertN((void**)&(A), I, NULL, 1) == -1) ? -1 : ((A)[DARR_OFFS(A)+(I)] = V, I))
+#define DYNARR_INSERT_N(A, I, P, N) dynarrInsertN((void**)&(A), I, P, N)
 #define DYNARR_SHOVE(A, I, V) (DARR_ASSERT(DYNARR_VALID(A, I)), (DYNARR_PUSH(A, (A)[DARR_OFFS(A)+(I)]) == -1) ? -1 : ((A)[DARR_OFFS(A)+(I)] = V, I))
-#define DYNARR_REMOVE(A, I) (DARR_ASSERT(DYNARR_VALID(A, I)), (void)memmove(&(A)[DARR_OFFS(A)+(I)], &(A)[DARR_OFFS(A)+(I)+1], DARR_ELEM(A)*(--DARR_SIZE(A)-(I))))
-#define DYNARR_DITCH(A, I) (DARR_ASSERT(DYNARR_VALID(A, I)), (A)[DARR_OFFS(A)+(I)] = DYNARR_POP(A), (void)0)
+#define DYNARR_REMOVE(A, I) (DARR_ASSERT(DYNARR_VALID(A, I)), dynarrRemoveRange((void**)&(A), I, 1))
+#define DYNARR_REMOVE_RANGE(A, I, N) dynarrRemoveRange((void**)&(A), I, N)
+#define DYNARR_DITCH(A, I) (DARR_ASSERT(DYNARR_VALID(A, I)), (A)[DARR_OFFS(A)+(I)] = (A)[DARR_OFFS(A)+--DARR_SIZE(A)], DARR_TRIM(A), (void)0)
 #define DYNARR_RESIZE(A, S) dynarrResize((void**)&(A), S)
 #define DYNARR_CAPACITY(A, C) dynarrCapacity((void**)&(A), C)
+#define DYNARR_SHRINK_TO_FIT(A) dynarrShrink((void**)&(A))
+#define DYNARR_FOREACH(T, A, N) for (T* N = &(A)[DARR_OFFS(A)], *N##_darr_end = N + DARR_SIZE(A); N < N##_darr_end; N++)
+#define DYNARR_MAP(A, F, C) dynarrMap(A, (void(*)(void*, void*))(F), C, NULL)
+#define DYNARR_MAP_PAR(A, F, C, E) dynarrMap(A, (void(*)(void*, void*))(F), C, E)
+#define DYNARR_REDUCE(A, F, P, C) dynarrReduce(A, (void(*)(void*, const void*, void*))(F), NULL, P, sizeof(*(P)), C, NULL)
+#define DYNARR_REDUCE_PAR(A, F, J, P, C, E) \
+    dynarrReduce(A, (void(*)(void*, const void*, void*))(F), (void(*)(void*, const void*, void*))(J), P, sizeof(*(P)), C, E)
+#define DYNARR_FILTER(A, F, C) dynarrFilter((void**)&(A), (int(*)(const void*, void*))(F), C, NULL)
+#define DYNARR_FILTER_PAR(A, F, C, E) dynarrFilter((void**)&(A), (int(*)(const void*, void*))(F), C, E)
 #define DYNARR_FIND_LIN(A, K) dynarrFindLinear(A, K)
 #define DYNARR_FIND_BIN(A, F, K) dynarrFindBinary(A, (int(*)(const void*, const void*))(F), K)
+#define DYNARR_LOWER_BOUND(A, F, K) dynarrLowerBound(A, (int(*)(const void*, const void*))(F), K)
+#define DYNARR_UPPER_BOUND(A, F, K) dynarrUpperBound(A, (int(*)(const void*, const void*))(F), K)
+#define DYNARR_EQUAL_RANGE(A, F, K, U) (*(U) = DYNARR_UPPER_BOUND(A, F, K), DYNARR_LOWER_BOUND(A, F, K))
+#define DYNARR_DEFINE_FIND(T, N) \
+    static DARRINT N##FindLinear (const T* a, T k) { \
+        const T* p = &a[DARR_OFFS(a)]; \
+        DARRINT n = DARR_SIZE(a), i = 0; \
+        for (; i+16 <= n; i += 16) { \
+            int hit = 0; \
+            for (int j = 0; j < 16; j++) hit |= (p[i+j] == k); \
+            if (hit) break; \
+        } \
+        for (; i < n; i++) if (p[i] == k) return i; \
+        return -1; \
+    } \
+    static DARRINT N##FindBinary (const T* a, T k) { \
+        const T* p = &a[DARR_OFFS(a)], *b = p; \
+        DARRINT n = DARR_SIZE(a); \
+        if (!n) return -1; \
+        for (DARRINT h; n > 1; n -= h) { \
+            h = n/2; \
+            b = (b[h] < k) ? &b[h] : b; \
+        } \
+        b += (*b < k); \
+        return ((b < &p[DARR_SIZE(a)])&&(*b == k)) ? (DARRINT)(b-p) : -1; \
+    }
+#define DYNARR_MERGE(D, A, B, F) dynarrSetOp((void**)&(D), A, B, (int(*)(const void*, const void*))(F), DARR_SET_MERGE)
+#define DYNARR_UNION(D, A, B, F) dynarrSetOp((void**)&(D), A, B, (int(*)(const void*, const void*))(F), DARR_SET_UNION)
+#define DYNARR_INTERSECT(D, A, B, F) dynarrSetOp((void**)&(D), A, B, (int(*)(const void*, const void*))(F), DARR_SET_INTERSECT)
+#define DYNARR_DIFFERENCE(D, A, B, F) dynarrSetOp((void**)&(D), A, B, (int(*)(const void*, const void*))(F), DARR_SET_DIFF)
+#define DYNARR_UNIQUE(A, F) dynarrUnique((void**)&(A), (int(*)(const void*, const void*))(F))
+#define DYNARR_DEFINE_SET(T, N) \
+    static inline DARRINT N##Gallop (const T* p, DARRINT n, T k) { \
+        DARRINT lo = 0, step = 1; \
+        while ((step <= n-lo)&&(p[lo+step-1] < k)) { lo += step; if (step < DARR_IMAX/2) step *= 2; } \
+        DARRINT hi = (step-1 < n-lo) ? lo+step-1 : n; \
+        while (lo < hi) { DARRINT m = lo + (hi-lo)/2; if (p[m] < k) lo = m+1; else hi = m; } \
+        return lo; \
+    } \
+    static inline DARRINT N##SetOp (T** d, const T* a, const T* b, int op) { \
+        DARR_ASSERT((*d != a)&&(*d != b)); \
+        DARRINT na = DARR_SIZE(a), nb = DARR_SIZE(b), i = 0, j = 0, k = 0; \
+        if ((op <= DARR_SET_UNION)&&(nb > DARR_IMAX-na)) return -1; \
+        DARRINT most = (op == DARR_SET_INTERSECT) ? ((na < nb) ? na : nb) : (op == DARR_SET_DIFF) ? na : na+nb; \
+        DARR_OFFS(*d) = DARR_SIZE(*d) = 0; \
+        if (dynarrReserve((void**)d, most)) return -1; \
+        const T* p = &a[DARR_OFFS(a)], *q = &b[DARR_OFFS(b)]; \
+        T* o = *d; \
+        if ((op == DARR_SET_INTERSECT)&&(na/16 > nb)) { \
+            for (; (j < nb)&&(i < na); j++) { \
+                i += N##Gallop(&p[i], na-i, q[j]); \
+                if ((i < na)&&(!(q[j] < p[i]))) o[k++] = p[i++]; \
+            } \
+        } else if ((op == DARR_SET_INTERSECT)&&(nb/16 > na)) { \
+            for (; (i < na)&&(j < nb); i++) { \
+                j += N##Gallop(&q[j], nb-j, p[i]); \
+                if ((j < nb)&&(!(p[i] < q[j]))) { o[k++] = p[i]; j++; } \
+            } \
+        } else { \
+            while ((i < na)&&(j < nb)) { \
+                T x = p[i], y = q[j]; \
+                int lt = x < y, gt = y < x; \
+                if (op == DARR_SET_MERGE) { o[k++] = gt ? y : x; i += !gt; j += gt; } \
+                else if (op == DARR_SET_UNION) { o[k++] = gt ? y : x; i += !gt; j += !lt; } \
+                else if (op == DARR_SET_INTERSECT) { o[k] = x; k += !(lt|gt); i += !gt; j += !lt; } \
+                else { o[k] = x; k += lt; i += !gt; j += !lt; } \
+            } \
+        } \
+        if (op != DARR_SET_INTERSECT) for (; i < na; i++) o[k++] = p[i]; \
+        if (op <= DARR_SET_UNION) for (; j < nb; j++) o[k++] = q[j]; \
+        DARR_SIZE(*d) = k; \
+        DARR_TRIM(*d); \
+        return k; \
+    } \
+    static inline DARRINT N##Merge (T** d, const T* a, const T* b) { return N##SetOp(d, a, b, DARR_SET_MERGE); } \
+    static inline DARRINT N##Union (T** d, const T* a, const T* b) { return N##SetOp(d, a, b, DARR_SET_UNION); } \
+    static inline DARRINT N##Intersect (T** d, const T* a, const T* b) { return N##SetOp(d, a, b, DARR_SET_INTERSECT); } \
+    static inline DARRINT N##Difference (T** d, const T* a, const T* b) { return N##SetOp(d, a, b, DARR_SET_DIFF); } \
+    static inline DARRINT N##Unique (T** a) { \
+        T* p = &(*a)[DARR_OFFS(*a)]; \
+        DARRINT n = DARR_SIZE(*a), k = (n > 0); \
+        for (DARRINT i = 1; i < n; i++) { p[k] = p[i]; k += (p[k-1] < p[i]); } \
+        DARR_SIZE(*a) = k; \
+        if (!k) DARR_OFFS(*a) = 0; \
+        DARR_TRIM(*a); \
+        return k; \
+    }
+#define DARR_SET_MERGE 0
+#define DARR_SET_UNION 1
+#define DARR_SET_INTERSECT 2
+#define DARR_SET_DIFF 3
+#define DYNARR_INSERT_SORTED(A, F, V) ((DYNARR_PUSH(A, V) == -1) ? -1 : dynarrSortLast(A, (int(*)(const void*, const void*))(F)))
 #define DYNARR_SORT_INS(A, F) dynarrSortInsert(A, (int(*)(const void*, const void*))(F))
 #define DYNARR_SORT_STD(A, F) dynarrSortStandard(A, (int(*)(const void*, const void*))(F))
-#define DARR_RAW(A) ((struct dynarr*)(A))[-1]
+#define DYNARR_SORT_RADIX(A, K) dynarrSortRadix(A, K)
+#define DYNARR_SORT_PAR(A, F, E) dynarrSortParallel(A, (int(*)(const void*, const void*))(F), E)
+#define DYNARR_FIND_PAR(A, K, E) dynarrFindParallel(A, K, E)
+#define DYNARR_RADIX_UINT 0
+#define DYNARR_RADIX_INT 1
+#define DYNARR_RADIX_FLOAT 2
+#define DYNARR_DEFINE(T, N) \
+    static inline T* N##New (void) { return (T*)dynarrNew(sizeof(T)); } \
+    static inline T* N##NewEx (DARRINT c) { return (T*)dynarrNewEx(sizeof(T), c, 0, NULL); } \
+    static inline void N##Free (T* a) { dynarrFree(a); } \
+    static inline DARRINT N##Size (const T* a) { return DARR_SIZE(a); } \
+    static inline void N##Clear (T* a) { DARR_OFFS(a) = DARR_SIZE(a) = 0; } \
+    static inline T* N##At (T* a, DARRINT i) { DARR_ASSERT(DYNARR_VALID(a, i)); return &a[DARR_OFFS(a)+i]; } \
+    static inline T N##Get (const T* a, DARRINT i) { DARR_ASSERT(DYNARR_VALID(a, i)); return a[DARR_OFFS(a)+i]; } \
+    static inline void N##Set (T* a, DARRINT i, T v) { DARR_ASSERT(DYNARR_VALID(a, i)); a[DARR_OFFS(a)+i] = v; } \
+    static inline T* N##Data (T* a) { return &a[DARR_OFFS(a)]; } \
+    static inline DARRINT N##Push (T** a, T v) { \
+        if (dynarrGrow((void**)a)) return -1; \
+        T* p = *a; \
+        p[DARR_OFFS(p)+DARR_SIZE(p)] = v; \
+        return DARR_SIZE(p)++; \
+    } \
+    static inline T N##Pop (T** a) { \
+        DARR_ASSERT(DARR_SIZE(*a)); \
+        T v = (*a)[DARR_OFFS(*a)+--DARR_SIZE(*a)]; \
+        DARR_TRIM(*a); \
+        return v; \
+    } \
+    static inline T N##Dequeue (T** a) { \
+        DARR_ASSERT(DARR_SIZE(*a)); \
+        T v = (*a)[DARR_OFFS(*a)++]; \
+        DARR_SIZE(*a)--; \
+        DARR_TRIM(*a); \
+        return v; \
+    } \
+    static inline DARRINT N##PushFront (T** a, T v) { \
+        if (dynarrGrowFront((void**)a)) return -1; \
+        T* p = *a; \
+        p[--DARR_OFFS(p)] = v; \
+        DARR_SIZE(p)++; \
+        return 0; \
+    } \
+    static inline T N##PopFront (T** a) { return N##Dequeue(a); } \
+    static inline DARRINT N##Append (T** a, const T* p, DARRINT n) { return dynarrAppend((void**)a, p, n); } \
+    static inline DARRINT N##Insert (T** a, DARRINT i, T v) { \
+        DARR_ASSERT(DYNARR_VALID(*a, i)); \
+        if (dynarrInsertN((void**)a, i, NULL, 1) == -1) return -1; \
+        (*a)[DARR_OFFS(*a)+i] = v; \
+        return i; \
+    } \
+    static inline void N##Remove (T** a, DARRINT i) { DARR_ASSERT(DYNARR_VALID(*a, i)); dynarrRemoveRange((void**)a, i, 1); } \
+    static inline void N##Ditch (T** a, DARRINT i) { \
+        DARR_ASSERT(DYNARR_VALID(*a, i)); \
+        T* p = *a; \
+        p[DARR_OFFS(p)+i] = p[DARR_OFFS(p)+--DARR_SIZE(p)]; \
+        DARR_TRIM(*a); \
+    } \
+    static inline int N##Reserve (T** a, DARRINT n) { return dynarrReserve((void**)a, n); } \
+    static inline DARRINT N##Resize (T** a, DARRINT s) { return dynarrResize((void**)a, s); } \
+    static inline DARRINT N##Find (const T* a, T k) { \
+        const T* p = &a[DARR_OFFS(a)]; \
+        for (DARRINT i = 0, n = DARR_SIZE(a); i < n; i++) if (!memcmp(&p[i], &k, sizeof(T))) return i; \
+        return -1; \
+    }
+#define DYNARR_DEFINE_SORT(T, N, F) \
+    static void N##SortSift (T* a, DARRINT r, DARRINT n) { \
+        for (DARRINT c; (c = 2*r+1) < n; r = c) { \
+            if ((c+1 < n)&&(F(&a[c], &a[c+1]) < 0)) c++; \
+            if (F(&a[r], &a[c]) >= 0) return; \
+            T t = a[r]; a[r] = a[c]; a[c] = t; \
+        } \
+    } \
+    static void N##SortIntro (T* a, DARRINT n, int depth) { \
+        while (n > 16) { \
+            if (!depth--) { \
+                for (DARRINT r = n/2; r-- > 0;) N##SortSift(a, r, n); \
+                while (--n > 0) { T t = a[0]; a[0] = a[n]; a[n] = t; N##SortSift(a, 0, n); } \
+                return; \
+            } \
+            T t, *m = &a[n/2], *h = &a[n-1]; \
+            if (F(m, a) < 0) { t = *m; *m = *a; *a = t; } \
+            if (F(h, m) < 0) { t = *h; *h = *m; *m = t; if (F(m, a) < 0) { t = *m; *m = *a; *a = t; } } \
+            t = *m; *m = *a; *a = t; \
+            DARRINT i = 0, j = n; \
+            for (;;) { \
+                do i++; while (F(&a[i], a) < 0); \
+                do j--; while (F(a, &a[j]) < 0); \
+                if (i >= j) break; \
+                t = a[i]; a[i] = a[j]; a[j] = t; \
+            } \
+            t = a[0]; a[0] = a[j]; a[j] = t; \
+            if (j < n-j-1) { N##SortIntro(a, j, depth); a += j+1; n -= j+1; } \
+            else { N##SortIntro(&a[j+1], n-j-1, depth); n = j; } \
+        } \
+        for (DARRINT i = 1; i < n; i++) { \
+            T v = a[i]; DARRINT j = i; \
+            for (; (j > 0)&&(F(&v, &a[j-1]) < 0); j--) a[j] = a[j-1]; \
+            a[j] = v; \
+        } \
+    } \
+    static void N##Sort (T* a) { \
+        int depth = 0; \
+        for (DARRINT n = DARR_SIZE(a); n > 1; n /= 2) depth += 2; \
+        N##SortIntro(&a[DARR_OFFS(a)], DARR_SIZE(a), depth); \
+    }
+#define DYNARR_RING_NEW(T, C) ((T*)DARR_TAG(dynarrRingNew(sizeof(T), C)))
+#define DYNARR_RING_AT(A, I) (*(DARR_ASSERT(DYNARR_VALID(A, I)), &(A)[(DARR_OFFS(A)+(I))&(DARR_CAPA(A)-1)]))
+#define DYNARR_RING_PUSH(A, V) (dynarrRingGrow((void**)&(A)) ? -1 : \
+    ((A)[(DARR_OFFS(A)+DARR_SIZE(A))&(DARR_CAPA(A)-1)] = V, DARR_SIZE(A)++))
+#define DYNARR_RING_POP(A) (DARR_ASSERT(DARR_SIZE(A)), (A)[(DARR_OFFS(A)+--DARR_SIZE(A))&(DARR_CAPA(A)-1)])
+#define DYNARR_RING_DEQUEUE(A) (DARR_ASSERT(DARR_SIZE(A)), DARR_SIZE(A)--, \
+    (A)[(DARR_OFFS(A) = (DARR_OFFS(A)+1)&(DARR_CAPA(A)-1), (DARR_OFFS(A)-1)&(DARR_CAPA(A)-1))])
+#define DYNARR_SPSC_NEW(T, C) ((T*)dynarrQueueNew(sizeof(T), C, 0))
+#define DYNARR_MPMC_NEW(T, C) ((T*)dynarrQueueNew(sizeof(T), C, 1))
+#define DYNARR_SPSC_PUSH(Q, P) (DARR_ASSERT(sizeof(*(P)) == sizeof(*(Q))), dynarrSpscPush(Q, P))
+#define DYNARR_SPSC_DEQUEUE(Q, P) (DARR_ASSERT(sizeof(*(P)) == sizeof(*(Q))), dynarrSpscDequeue(Q, P))
+#define DYNARR_MPMC_PUSH(Q, P) (DARR_ASSERT(sizeof(*(P)) == sizeof(*(Q))), dynarrMpmcPush(Q, P))
+#define DYNARR_MPMC_DEQUEUE(Q, P) (DARR_ASSERT(sizeof(*(P)) == sizeof(*(Q))), dynarrMpmcDequeue(Q, P))
+#define DYNARR_QUEUE_SIZE(Q) dynarrQueueSize(Q)
+#define DYNARR_QUEUE_FREE(Q) dynarrQueueFree(Q)
+#define DYNARR_SNAPSHOT(T, A) ((const T*)dynarrSnapshot(A))
+#define DYNARR_RELEASE(S) dynarrFree((void*)(S))
+#define DYNARR_UNSHARE(A) dynarrUnshare((void**)&(A))
+#define DARR_QUEUE(Q) ((struct dynarrqueue*)(Q))[-1]
+#define DYNARR_HASH_INIT(H, F, C) dynarrHashInit(H, (size_t(*)(const void*))(F), (int(*)(const void*, const void*))(C))
+#define DYNARR_HASH_BUILD(A, H) dynarrHashBuild(H, A)
+#define DYNARR_HASH_FIND(A, H, K) dynarrHashFind(H, A, K)
+#define DYNARR_HASH_PUSH(A, H, V) ((DYNARR_PUSH(A, V) == -1) ? -1 : dynarrHashAdd(H, A))
+#define DYNARR_HASH_POP(A, H) (DARR_ASSERT(DARR_SIZE(A)), dynarrHashDitch(H, A, DARR_SIZE(A)-1), DYNARR_POP(A))
+#define DYNARR_HASH_DITCH(A, H, I) (DARR_ASSERT(DYNARR_VALID(A, I)), dynarrHashDitch(H, A, I), DYNARR_DITCH(A, I))
+#define DYNARR_HASH_REMOVE(A, H, I) (DARR_ASSERT(DYNARR_VALID(A, I)), dynarrHashRemove(H, A, I), DYNARR_REMOVE(A, I))
+#define DYNARR_HASH_FREE(H) dynarrHashFree(H)
+#define DYNARR_SLOTMAP_INIT(T, M) dynarrSlotmapInit(M, sizeof(T))
+#define DYNARR_SLOTMAP_INSERT(M, P) (DARR_ASSERT(sizeof(*(P)) == (size_t)DARR_ELEM((M)->dense)), dynarrSlotmapInsert(M, P))
+#define DYNARR_SLOTMAP_REMOVE(M, H) dynarrSlotmapRemove(M, H)
+#define DYNARR_SLOTMAP_GET(T, M, H) ((T*)dynarrSlotmapGet(M, H))
+#define DYNARR_SLOTMAP_DENSE(T, M) ((T*)(M)->dense)
+#define DYNARR_SLOTMAP_SIZE(M) DARR_SIZE((M)->dense)
+#define DYNARR_SLOTMAP_HANDLE(M, I) (DARR_ASSERT(DYNARR_VALID((M)->owner, I)), \
+    ((uint64_t)(M)->slots[(M)->owner[I]].gen << 32 | (M)->owner[I]))
+#define DYNARR_SLOTMAP_FREE(M) dynarrSlotmapFree(M)
+#define DYNARR_SEG_INIT(T, S, C) dynarrSegInit(S, sizeof(T), C)
+#define DYNARR_SEG_SIZE(S) ((S)->size)
+#define DYNARR_SEG_AT(T, S, I) (*(DARR_ASSERT((sizeof(T) == (size_t)(S)->elem)&&((I) >= 0)&&((I) < (S)->size)), \
+    (T*)DARR_SEG_PTR(S, I)))
+#define DYNARR_SEG_PUSH(T, S, V) (DARR_ASSERT(sizeof(T) == (size_t)(S)->elem), dynarrSegReserve(S, 1) ? -1 : \
+    (*(T*)DARR_SEG_PTR(S, (S)->size) = V, (S)->size++))
+#define DYNARR_SEG_POP(T, S) (DARR_ASSERT((sizeof(T) == (size_t)(S)->elem)&&((S)->size)), (S)->size--, \
+    *(T*)DARR_SEG_PTR(S, (S)->size))
+#define DYNARR_SEG_DEQUEUE(T, S) (DARR_ASSERT((sizeof(T) == (size_t)(S)->elem)&&((S)->size)), *(T*)dynarrSegDequeue(S))
+#define DYNARR_SEG_RESERVE(S, N) dynarrSegReserve(S, N)
+#define DYNARR_SEG_SHRINK(S) dynarrSegShrink(S)
+#define DYNARR_SEG_CLEAR(S) ((S)->offs = (S)->size = 0, (void)0)
+#define DYNARR_SEG_FREE(S) dynarrSegFree(S)
+#define DARR_SEG_PTR(S, I) ((char*)(S)->chunks[DARR_OFFS((S)->chunks) + (((S)->offs+(I)) >> (S)->shift)] + \
+    (size_t)(S)->elem*(((S)->offs+(I)) & (((DARRINT)1 << (S)->shift)-1)))
+#define DYNARR_SOA_NEW(C, E, N) dynarrSoaNew(C, E, N)
+#define DYNARR_SOA_COL(T, S, C) (DARR_ASSERT(sizeof(T) == DARR_SOA_ELEM(S)[C]), \
+    (T*)((char*)(S) + DARR_SOA_POS(S)[C]) + (S)->offs)
+#define DYNARR_SOA_SIZE(S) ((S)->size)
+#define DYNARR_SOA_PUSH(S) (dynarrSoaReserve(&(S), 1) ? -1 : (S)->size++)
+#define DYNARR_SOA_POP(S) (DARR_ASSERT((S)->size), (S)->size--, (void)0)
+#define DYNARR_SOA_DEQUEUE(S) (DARR_ASSERT((S)->size), (S)->offs = --(S)->size ? (S)->offs+1 : 0, (void)0)
+#define DYNARR_SOA_DITCH(S, I) dynarrSoaDitch(S, I)
+#define DYNARR_SOA_RESERVE(S, N) dynarrSoaReserve(&(S), N)
+#define DYNARR_SOA_RESIZE(S, N) dynarrSoaResize(&(S), N)
+#define DYNARR_SOA_CLEAR(S) ((S)->offs = (S)->size = 0, (void)0)
+#define DYNARR_SOA_FREE(S) dynarrSoaFree(S)
+#define DARR_SOA_HEAD ((sizeof(struct dynarrsoa)+15)/16*16)
+#define DARR_SOA_ELEM(S) ((size_t*)((char*)(S) + DARR_SOA_HEAD))
+#define DARR_SOA_POS(S) (DARR_SOA_ELEM(S) + (S)->cols)
+#define DYNARR_MAP_OPEN(T, M, P) ((T*)DARR_TAG(dynarrMapOpen(M, P, sizeof(T))))
+#define DYNARR_MAP_SYNC(A) dynarrMapSync(A)
+#define DYNARR_SAVE(A, F, L) dynarrSave(A, F, L)
+#define DYNARR_LOAD(T, F) ((T*)DARR_TAG(dynarrLoad(F, sizeof(T))))
+#define DYNARR_VIEW(T, P, S) ((const T*)dynarrView(P, S, sizeof(T)))
+#define DYNARR_WIRE_SIZE(A) (DARR_WIRE + (size_t)DARR_ELEM(A)*DARR_SIZE(A))
+#define DYNARR_WIRE_CHECKSUM 1
+#define DYNARR_HUGE_INTERLEAVE 1
+#define DYNARR_HUGE_2MB 2
+#define DYNARR_HUGE_1GB 4
+#define DYNARR_STATS_GET(A) ((const struct dynarrstats*)&DARR_RAW(A).stat)
+#define DYNARR_STATS_TOTAL() dynarrStatsTotal()
+#define DYNARR_STATS_TAG(A, S) (DARR_RAW(A).stat.tag = (S), (void)0)
+#define DYNARR_STATS_HOOK(F) dynarrStatsHook((void(*)(const void*, size_t, size_t, const char*))(F))
+#ifdef DYNARR_STATS
+    #define DARR_TAG(P) dynarrStatsTag(P, __FILE__ ":" DARR_STRX(__LINE__))
+#else
+    #define DARR_TAG(P) (P)
+#endif
+#define DARR_STR(X) #X
+#define DARR_STRX(X) DARR_STR(X)
+#ifdef DYNARR_AUTO_SHRINK
+    #define DARR_TRIM(A) ((DARR_SIZE(A) < DARR_CAPA(A)/(DYNARR_AUTO_SHRINK)) ? (void)dynarrTrim((void**)&(A)) : (void)0)
+#else
+    #define DARR_TRIM(A) ((void)0)
+#endif
+#define DARR_HEAD ((sizeof(struct dynarr)+15)/16*16)
+#define DARR_RAW(A) (*(struct dynarr*)((char*)(A)-DARR_HEAD))
+#define DARR_BASE(A) ((char*)(A)-DARR_HEAD-DARR_RAW(A).padd)
+#define DARR_BYTES(E, C, L) (DARR_HEAD + DARR_SLACK(L) + (size_t)(E)*(C))
+#define DARR_SLACK(L) (((L) > 1) ? (size_t)(L)-1 : 0)
+#define DARR_POOL_CLASSES 12
+#define DARR_FLAG_BORROW 1
+#define DARR_PAR_MIN 4096
+#define DARR_WIRE 256
+#define DARR_WIRE_V1 128
+#define DARR_WIRE_VERSION 2
 #define DARR_CAPA(A) DARR_RAW(A).capa
 #define DARR_ELEM(A) DARR_RAW(A).elem
 #define DARR_OFFS(A) DARR_RAW(A).offs
@@ -142,22 +944,212 @@ void DYNARR_SORT_STD(any*, int(*)(const any*, const any*))
 
 //includes
 #include <string.h> //memmove
+#include <stdint.h> //uint32_t
+#include <stdio.h> //FILE
+#ifdef DYNARR_ATOMIC
+    #ifdef __cplusplus
+        //the same atomics live in namespace std, only C++23 maps them into the global namespace through <stdatomic.h>
+        #include <atomic> //std::atomic
+        using std::atomic_int; using std::atomic_size_t; using std::atomic_uint_least64_t;
+        using std::atomic_init; using std::atomic_load_explicit; using std::atomic_store_explicit;
+        using std::atomic_fetch_add_explicit; using std::atomic_fetch_sub_explicit;
+        using std::atomic_compare_exchange_weak_explicit;
+        using std::memory_order_relaxed; using std::memory_order_acquire;
+        using std::memory_order_release; using std::memory_order_acq_rel;
+        #define DARR_ALIGNAS(N) alignas(N)
+    #else
+        #include <stdatomic.h> //atomics
+        #define DARR_ALIGNAS(N) _Alignas(N)
+    #endif
+    #include <stddef.h> //ptrdiff_t
+    #ifndef DYNARR_CACHE_LINE
+        #define DYNARR_CACHE_LINE 64
+    #endif
+#endif
 
 //structs
+#ifdef DYNARR_STATS
+struct dynarrstats {
+    uint64_t reallocs, compacted, moved, compares;
+    size_t peak;
+    const char* tag;
+};
+#endif
 struct dynarr {
-    int capa, elem, offs, size;
+    DARRINT capa, elem, offs, size;
+    int alig, padd, flag;
+    struct dynarralloc* allo;
+    #ifdef DYNARR_ATOMIC
+    atomic_int refs;
+    #endif
+    #ifdef DYNARR_STATS
+    struct dynarrstats stat;
+    #endif
+};
+struct dynarralloc {
+    void* (*func)(struct dynarralloc*, void*, size_t, size_t);
+};
+struct dynarrslot {
+    uint32_t gen, index;
+};
+struct dynarrslotmap {
+    void* dense;
+    uint32_t* owner;
+    struct dynarrslot* slots;
+    uint32_t free;
+};
+struct dynarrseg {
+    void** chunks;
+    DARRINT elem, offs, size;
+    int shift;
+};
+struct dynarrhashslot {
+    size_t hash;
+    DARRINT index;
+};
+struct dynarrhash {
+    struct dynarrhashslot* slots;
+    size_t mask, count;
+    size_t (*hash)(const void*);
+    int (*comp)(const void*, const void*);
+};
+struct dynarrsoa {
+    DARRINT capa, offs, size;
+    int cols, padd;
 };
+struct dynarrexec {
+    void (*run)(struct dynarrexec*, void(*)(void*, DARRINT), void*, DARRINT);
+    int threads;
+};
+struct dynarrarena {
+    struct dynarralloc base;
+    char* data;
+    size_t size, used, last;
+};
+struct dynarrpool {
+    struct dynarralloc base;
+    void* free[DARR_POOL_CLASSES];
+    void* slabs;
+};
+#ifdef DYNARR_ATOMIC
+struct dynarrqueue {
+    //shared line, read-only after creation
+    DARR_ALIGNAS(DYNARR_CACHE_LINE) size_t mask, elem;
+    atomic_size_t* seqs;
+    void* base;
+    //consumer line, with consumer's cached copy of tail
+    DARR_ALIGNAS(DYNARR_CACHE_LINE) atomic_size_t head;
+    size_t tail_cache;
+    //producer line, with producer's cached copy of head
+    DARR_ALIGNAS(DYNARR_CACHE_LINE) atomic_size_t tail;
+    size_t head_cache;
+};
+#endif
+#ifdef DYNARR_MMAP
+struct dynarrmap {
+    struct dynarralloc base;
+    int fd;
+    size_t size;
+};
+struct dynarrhuge {
+    struct dynarralloc base;
+    size_t thresh;
+    unsigned long nodes;
+    int flags;
+};
+#endif
 
 //function declarations
-DARRDEF void* dynarrNew(int);
+#ifdef __cplusplus
+extern "C" {
+#endif
+DARRDEF void* dynarrNew(DARRINT);
+DARRDEF void* dynarrNewEx(DARRINT, DARRINT, int, struct dynarralloc*);
+DARRDEF void* dynarrNewInline(DARRINT, int, void*, size_t);
 DARRDEF void dynarrFree(void*);
+DARRDEF void dynarrArenaInit(struct dynarrarena*, void*, size_t);
+DARRDEF void dynarrArenaReset(struct dynarrarena*);
+DARRDEF void dynarrPoolInit(struct dynarrpool*);
+DARRDEF void dynarrPoolDestroy(struct dynarrpool*);
 DARRDEF int dynarrGrow(void**);
-DARRDEF int dynarrResize(void**, int);
-DARRDEF int dynarrCapacity(void**, int);
-DARRDEF int dynarrFindLinear(const void*, const void*);
-DARRDEF int dynarrFindBinary(const void*, int(*)(const void*, const void*), const void*);
+DARRDEF int dynarrGrowFront(void**);
+DARRDEF int dynarrReserve(void**, DARRINT);
+DARRDEF DARRINT dynarrAppend(void**, const void*, DARRINT);
+DARRDEF DARRINT dynarrInsertN(void**, DARRINT, const void*, DARRINT);
+DARRDEF void dynarrRemoveRange(void**, DARRINT, DARRINT);
+DARRDEF int dynarrSlotmapInit(struct dynarrslotmap*, DARRINT);
+DARRDEF void dynarrSlotmapFree(struct dynarrslotmap*);
+DARRDEF uint64_t dynarrSlotmapInsert(struct dynarrslotmap*, const void*);
+DARRDEF int dynarrSlotmapRemove(struct dynarrslotmap*, uint64_t);
+DARRDEF void* dynarrSlotmapGet(struct dynarrslotmap*, uint64_t);
+DARRDEF int dynarrSegInit(struct dynarrseg*, DARRINT, DARRINT);
+DARRDEF void dynarrSegFree(struct dynarrseg*);
+DARRDEF int dynarrSegReserve(struct dynarrseg*, DARRINT);
+DARRDEF void* dynarrSegDequeue(struct dynarrseg*);
+DARRDEF void dynarrSegShrink(struct dynarrseg*);
+DARRDEF void dynarrHashInit(struct dynarrhash*, size_t(*)(const void*), int(*)(const void*, const void*));
+DARRDEF void dynarrHashFree(struct dynarrhash*);
+DARRDEF int dynarrHashBuild(struct dynarrhash*, const void*);
+DARRDEF DARRINT dynarrHashFind(const struct dynarrhash*, const void*, const void*);
+DARRDEF DARRINT dynarrHashAdd(struct dynarrhash*, void*);
+DARRDEF void dynarrHashDitch(struct dynarrhash*, const void*, DARRINT);
+DARRDEF void dynarrHashRemove(struct dynarrhash*, const void*, DARRINT);
+DARRDEF struct dynarrsoa* dynarrSoaNew(int, const size_t*, DARRINT);
+DARRDEF void dynarrSoaFree(struct dynarrsoa*);
+DARRDEF int dynarrSoaReserve(struct dynarrsoa**, DARRINT);
+DARRDEF DARRINT dynarrSoaResize(struct dynarrsoa**, DARRINT);
+DARRDEF void dynarrSoaDitch(struct dynarrsoa*, DARRINT);
+DARRDEF void* dynarrRingNew(DARRINT, DARRINT);
+DARRDEF int dynarrRingGrow(void**);
+DARRDEF DARRINT dynarrResize(void**, DARRINT);
+DARRDEF DARRINT dynarrCapacity(void**, DARRINT);
+DARRDEF DARRINT dynarrShrink(void**);
+DARRDEF DARRINT dynarrTrim(void**);
+DARRDEF int dynarrSave(const void*, FILE*, int);
+DARRDEF void* dynarrLoad(FILE*, DARRINT);
+DARRDEF void* dynarrView(void*, size_t, DARRINT);
+DARRDEF DARRINT dynarrFindLinear(const void*, const void*);
+DARRDEF DARRINT dynarrFindBinary(const void*, int(*)(const void*, const void*), const void*);
+DARRDEF DARRINT dynarrLowerBound(const void*, int(*)(const void*, const void*), const void*);
+DARRDEF DARRINT dynarrUpperBound(const void*, int(*)(const void*, const void*), const void*);
+DARRDEF DARRINT dynarrSetOp(void**, const void*, const void*, int(*)(const void*, const void*), int);
+DARRDEF DARRINT dynarrUnique(void**, int(*)(const void*, const void*));
+DARRDEF DARRINT dynarrSortLast(void*, int(*)(const void*, const void*));
 DARRDEF void dynarrSortInsert(void*, int(*)(const void*, const void*));
 DARRDEF void dynarrSortStandard(void*, int(*)(const void*, const void*));
+DARRDEF int dynarrSortRadix(void*, int);
+DARRDEF void dynarrSortParallel(void*, int(*)(const void*, const void*), struct dynarrexec*);
+DARRDEF DARRINT dynarrFindParallel(const void*, const void*, struct dynarrexec*);
+DARRDEF void dynarrMap(void*, void(*)(void*, void*), void*, struct dynarrexec*);
+DARRDEF void dynarrReduce(const void*, void(*)(void*, const void*, void*), void(*)(void*, const void*, void*), void*, size_t, void*, struct dynarrexec*);
+DARRDEF DARRINT dynarrFilter(void**, int(*)(const void*, void*), void*, struct dynarrexec*);
+#ifdef DYNARR_THREADS
+DARRDEF void dynarrExecThreads(struct dynarrexec*, int);
+#endif
+#ifdef DYNARR_STATS
+DARRDEF void* dynarrStatsTag(void*, const char*);
+DARRDEF const struct dynarrstats* dynarrStatsTotal(void);
+DARRDEF void dynarrStatsHook(void(*)(const void*, size_t, size_t, const char*));
+#endif
+#ifdef DYNARR_ATOMIC
+DARRDEF void* dynarrQueueNew(DARRINT, DARRINT, int);
+DARRDEF void dynarrQueueFree(void*);
+DARRDEF const void* dynarrSnapshot(const void*);
+DARRDEF int dynarrUnshare(void**);
+DARRDEF DARRINT dynarrQueueSize(const void*);
+DARRDEF int dynarrSpscPush(void*, const void*);
+DARRDEF int dynarrSpscDequeue(void*, void*);
+DARRDEF int dynarrMpmcPush(void*, const void*);
+DARRDEF int dynarrMpmcDequeue(void*, void*);
+#endif
+#ifdef DYNARR_MMAP
+DARRDEF void* dynarrMapOpen(struct dynarrmap*, const char*, DARRINT);
+DARRDEF int dynarrMapSync(void*);
+DARRDEF void dynarrHugeInit(struct dynarrhuge*, size_t, int, unsigned long);
+#endif
+#ifdef __cplusplus
+}
+#endif
 
 #endif //DYNARR_H
 
@@ -175,124 +1167,1877 @@ DARRDEF void dynarrSortStandard(void*, int(*)(const void*, const void*));
 #ifndef DYNARR_FFREE
     #define DYNARR_FFREE(P) free(P)
 #endif
-#define DARR_EPTR(A, I) (&((char*)(A))[DARR_ELEM(A)*(DARR_OFFS(A)+(I))])
+#ifndef DYNARR_GROWTH
+    #define DYNARR_GROWTH 2
+#endif
+#ifndef DYNARR_MIN_CAPACITY
+    #define DYNARR_MIN_CAPACITY 1
+#endif
+#ifndef DYNARR_MAX_GROWTH
+    #define DYNARR_MAX_GROWTH 0
+#endif
+#ifndef DYNARR_MAX_THREADS
+    #define DYNARR_MAX_THREADS 64
+#endif
+#define DARR_EPTR(A, I) (&((char*)(A))[(size_t)DARR_ELEM(A)*(DARR_OFFS(A)+(I))])
+#define DARR_SMAX ((size_t)-1)
+#define DARR_SOA_ALIG 64
+#define DARR_SOA_BODY(N) (((DARR_SOA_HEAD + 2*sizeof(size_t)*(N)) + DARR_SOA_ALIG-1)/DARR_SOA_ALIG*DARR_SOA_ALIG)
+#define DARR_CHUNK(B, I) ((B)->p + (B)->elem*((size_t)(B)->n*(I)/(B)->parts))
+#ifdef DYNARR_STATS
+    #if defined(__cplusplus)&&(__cplusplus >= 201103L)
+        #define DARR_TLS thread_local
+    #elif defined(__STDC_VERSION__)&&(__STDC_VERSION__ >= 201112L)
+        #define DARR_TLS _Thread_local
+    #elif defined(__GNUC__)
+        #define DARR_TLS __thread
+    #else
+        #define DARR_TLS
+    #endif
+    #ifdef DYNARR_ATOMIC
+        #define DARR_STAT_ADD(F, N) ((void)atomic_fetch_add_explicit(&dynarrStatsSum.F, (N), memory_order_relaxed))
+    #else
+        #define DARR_STAT_ADD(F, N) (dynarrStatsSum.F += (N), (void)0)
+    #endif
+    #define DARR_STAT(A, F, N) (DARR_RAW(A).stat.F += (N), DARR_STAT_ADD(F, N))
+    #define DARR_STAT_FLUSH(A) dynarrStatsFlush(A)
+    #define DARR_STAT_FLUSH_TOTAL() dynarrStatsFlush(NULL)
+    #define DARR_STAT_MARK(C) uint64_t C = dynarrStatsComps
+    #define DARR_STAT_TASK(S, I, C) ((S)->comps[I] = dynarrStatsComps - (C), dynarrStatsComps = (C), (void)0)
+    #define DARR_STAT_GATHER(S, N) dynarrStatsGather((S)->comps, N)
+    #define DARR_STAT_REALLOC(A, O, N) dynarrStatsRealloc(A, O, N)
+    #define DARR_STAT_FREE(A, O) (dynarrStatsHookFunc ? dynarrStatsHookFunc(A, O, 0, DARR_RAW(A).stat.tag) : (void)0)
+    #define DARR_COMP(F, X, Y) (dynarrStatsComps++, (F)(X, Y))
+#else
+    #define DARR_STAT(A, F, N) ((void)0)
+    #define DARR_STAT_FLUSH(A) ((void)0)
+    #define DARR_STAT_FLUSH_TOTAL() ((void)0)
+    #define DARR_STAT_MARK(C) ((void)0)
+    #define DARR_STAT_TASK(S, I, C) ((void)0)
+    #define DARR_STAT_GATHER(S, N) ((void)0)
+    #define DARR_STAT_REALLOC(A, O, N) ((void)0)
+    #define DARR_STAT_FREE(A, O) ((void)0)
+    #define DARR_COMP(F, X, Y) (F)(X, Y)
+#endif
 
 //includes
 #include <stdlib.h> //memory allocation
+#include <stdint.h> //uintptr_t
+#ifdef DYNARR_THREADS
+    #include <pthread.h> //pthread_create
+    #include <unistd.h> //sysconf
+#endif
+#ifdef DYNARR_MMAP
+    #include <sys/mman.h> //mmap
+    #include <sys/stat.h> //fstat
+    #include <fcntl.h> //open
+    #include <unistd.h> //ftruncate
+    #if (defined(__linux__))&&((defined(_GNU_SOURCE))||(defined(_DEFAULT_SOURCE))||(defined(_BSD_SOURCE)))
+        #include <sys/syscall.h> //SYS_mbind
+    #endif
+#endif
+
+//internal functions
+#ifdef DYNARR_STATS
+#ifdef DYNARR_ATOMIC
+//process-wide totals, relaxed since they are only ever read as a whole by DYNARR_STATS_TOTAL
+struct dynarrstatsum {
+    atomic_uint_least64_t reallocs, compacted, moved, compares;
+    atomic_size_t peak;
+};
+static struct dynarrstatsum dynarrStatsSum;
+static DARR_TLS struct dynarrstats dynarrStatsCopy;
+#else
+static DARR_TLS struct dynarrstats dynarrStatsSum;
+#endif
+//comparator calls made by this thread that haven't been attributed to a dynarr yet
+static DARR_TLS uint64_t dynarrStatsComps;
+static void (*dynarrStatsHookFunc)(const void*, size_t, size_t, const char*);
+static void dynarrStatsPeak (void* a, size_t size) {
+    //track largest allocation of this dynarr and of all dynarrs
+    if (size > DARR_RAW(a).stat.peak) DARR_RAW(a).stat.peak = size;
+    #ifdef DYNARR_ATOMIC
+    size_t peak = atomic_load_explicit(&dynarrStatsSum.peak, memory_order_relaxed);
+    while ((size > peak)&&(!atomic_compare_exchange_weak_explicit(&dynarrStatsSum.peak, &peak, size,
+        memory_order_relaxed, memory_order_relaxed)));
+    #else
+    if (size > dynarrStatsSum.peak) dynarrStatsSum.peak = size;
+    #endif
+}
+static void dynarrStatsFlush (void* a) {
+    //count comparator calls made since the last flush towards the totals and given dynarr if any in one go
+    uint64_t n = dynarrStatsComps;
+    dynarrStatsComps = 0;
+    if (a) DARR_RAW(a).stat.compares += n;
+    DARR_STAT_ADD(compares, n);
+}
+static void dynarrStatsGather (const uint64_t* comps, size_t n) {
+    //take over comparator calls that parallel tasks made on whatever thread they ran on
+    for (size_t i = 0; i < n; i++) dynarrStatsComps += comps[i];
+}
+static void dynarrStatsRealloc (void* a, size_t olds, size_t news) {
+    //count reallocation, then report it along with the caller tag
+    DARR_STAT(a, reallocs, 1);
+    dynarrStatsPeak(a, news);
+    if (dynarrStatsHookFunc) dynarrStatsHookFunc(a, olds, news, DARR_RAW(a).stat.tag);
+}
+#endif
+static int dynarrPadding (const char* base, int alig) {
+    //number of bytes needed in front of the header for elements to be aligned
+    return (alig > 1) ? (int)((alig - (uintptr_t)(base + DARR_HEAD)%alig)%alig) : 0;
+}
+static int dynarrSpill (void** a, DARRINT c) {
+    //borrowed storage can simply be used less
+    if (c <= DARR_CAPA(*a)) {
+        DARR_CAPA(*a) = c;
+        return 0;
+    }
+    //allocate owned storage, through the allocator if there is one
+    struct dynarralloc* allo = DARR_RAW(*a).allo;
+    int alig = DARR_RAW(*a).alig;
+    size_t size = DARR_BYTES(DARR_ELEM(*a), c, alig);
+    char* ptr = (char*)(allo ? allo->func(allo, NULL, 0, size) : DYNARR_REALLOC(NULL, size));
+    if (!ptr) return -1;
+    //copy over header and elements keeping the alignment, never touching the borrowed storage again
+    int padd = dynarrPadding(ptr, alig);
+    memcpy(ptr + padd, &DARR_RAW(*a), DARR_HEAD + (size_t)DARR_ELEM(*a)*DARR_CAPA(*a));
+    *a = ptr + padd + DARR_HEAD;
+    DARR_RAW(*a).padd = padd;
+    DARR_RAW(*a).flag &= ~DARR_FLAG_BORROW;
+    DARR_CAPA(*a) = c;
+    DARR_STAT_REALLOC(*a, 0, size);
+    //return
+    return 0;
+}
+static int dynarrRealloc (void** a, DARRINT c) {
+    int alig = DARR_RAW(*a).alig, padd = DARR_RAW(*a).padd;
+    struct dynarralloc* allo = DARR_RAW(*a).allo;
+    //check for byte size overflow
+    if ((size_t)c > (DARR_SMAX - DARR_HEAD - DARR_SLACK(alig))/DARR_ELEM(*a)) return -1;
+    //storage that isn't owned can't be reallocated
+    if (DARR_RAW(*a).flag & DARR_FLAG_BORROW) return dynarrSpill(a, c);
+    //adjust capacity by reallocation, through the allocator if there is one
+    size_t olds = DARR_BYTES(DARR_ELEM(*a), DARR_CAPA(*a), alig), size = DARR_BYTES(DARR_ELEM(*a), c, alig);
+    char* ptr = (char*)(allo ? allo->func(allo, DARR_BASE(*a), olds, size) : DYNARR_REALLOC(DARR_BASE(*a), size));
+    //check for realloc failure
+    if (!ptr) return -1;
+    //restore alignment if the allocation moved to a different boundary
+    int npad = dynarrPadding(ptr, alig);
+    if (npad != padd) {
+        DARRINT keep = (c < ((struct dynarr*)(ptr+padd))->capa) ? c : ((struct dynarr*)(ptr+padd))->capa;
+        memmove(ptr+npad, ptr+padd, DARR_HEAD + (size_t)((struct dynarr*)(ptr+padd))->elem*keep);
+        ((struct dynarr*)(ptr+npad))->padd = npad;
+    }
+    //assign to dynarr pointer
+    *a = ptr + npad + DARR_HEAD;
+    //update allocated capacity
+    DARR_CAPA(*a) = c;
+    DARR_STAT_REALLOC(*a, olds, size);
+    //return
+    return 0;
+}
+static void* dynarrArenaFunc (struct dynarralloc* allo, void* ptr, size_t olds, size_t news) {
+    struct dynarrarena* arena = (struct dynarrarena*)allo;
+    //check if given pointer is the most recent allocation
+    int last = (ptr)&&((char*)ptr == arena->data + arena->last);
+    if (!news) {
+        //only the most recent allocation can be given back
+        if (last) arena->used = arena->last;
+        return NULL;
+    }
+    if (last) {
+        //resize most recent allocation in place if it fits
+        if (news > arena->size - arena->last) return NULL;
+        arena->used = arena->last + news;
+        return ptr;
+    }
+    //bump allocate at the next 16 byte boundary
+    size_t start = (arena->used + 15)/16*16;
+    if ((start > arena->size)||(news > arena->size - start)) return NULL;
+    arena->last = start;
+    arena->used = start + news;
+    //copy over contents of the old allocation, which is simply left behind
+    if (ptr) memcpy(arena->data + start, ptr, (olds < news) ? olds : news);
+    return arena->data + start;
+}
+static int dynarrPoolClass (size_t size) {
+    //index of the smallest power of two size class from 32 bytes up that fits, or -1 if too large
+    int c = 0;
+    while ((c < DARR_POOL_CLASSES)&&(((size_t)32 << c) < size)) c++;
+    return (c < DARR_POOL_CLASSES) ? c : -1;
+}
+static void* dynarrPoolFunc (struct dynarralloc* allo, void* ptr, size_t olds, size_t news) {
+    struct dynarrpool* pool = (struct dynarrpool*)allo;
+    int oc = ptr ? dynarrPoolClass(olds) : -1, nc = news ? dynarrPoolClass(news) : -1;
+    //large allocations go straight through
+    if ((ptr)&&(oc < 0)&&(news)&&(nc < 0)) return DYNARR_REALLOC(ptr, news);
+    //keep block if it stays within the same size class
+    if ((ptr)&&(oc >= 0)&&(oc == nc)) return ptr;
+    //get new block, from the free list of its class if possible
+    void* mem = NULL;
+    if (news) {
+        if (nc < 0) {
+            //too large for any size class
+            mem = DYNARR_REALLOC(NULL, news);
+        } else {
+            if (!pool->free[nc]) {
+                //carve a new slab into blocks of this class, keeping its first 16 bytes for the slab list
+                size_t block = (size_t)32 << nc, count = (block < 4096) ? 65536/block : 16;
+                char* slab = (char*)DYNARR_REALLOC(NULL, 16 + block*count);
+                if (!slab) return NULL;
+                *(void**)slab = pool->slabs;
+                pool->slabs = slab;
+                for (size_t i = count; i-- > 0;) {
+                    *(void**)(slab + 16 + i*block) = pool->free[nc];
+                    pool->free[nc] = slab + 16 + i*block;
+                }
+            }
+            mem = pool->free[nc];
+            pool->free[nc] = *(void**)mem;
+        }
+        if (!mem) return NULL;
+        //copy over contents of the old block
+        if (ptr) memcpy(mem, ptr, (olds < news) ? olds : news);
+    }
+    //release old block, to its free list if it came from a size class
+    if (ptr) {
+        if (oc < 0) {
+            DYNARR_FFREE(ptr);
+        } else {
+            *(void**)ptr = pool->free[oc];
+            pool->free[oc] = ptr;
+        }
+    }
+    //return
+    return mem;
+}
+#ifdef DYNARR_MMAP
+static void* dynarrMapFunc (struct dynarralloc* allo, void* ptr, size_t olds, size_t news) {
+    struct dynarrmap* map = (struct dynarrmap*)allo;
+    (void)olds;
+    if (!news) {
+        //unmap and close, the file keeps its contents
+        if (ptr) munmap(ptr, map->size);
+        close(map->fd);
+        map->fd = -1;
+        return NULL;
+    }
+    //resize file first, so the new mapping is fully backed
+    if (ftruncate(map->fd, (off_t)news)) return NULL;
+    void* mem;
+    if (!ptr) {
+        mem = mmap(NULL, news, PROT_READ|PROT_WRITE, MAP_SHARED, map->fd, 0);
+    } else {
+        #ifdef MREMAP_MAYMOVE
+        mem = mremap(ptr, map->size, news, MREMAP_MAYMOVE);
+        #else
+        //contents live in the file, so a fresh mapping sees them too
+        mem = mmap(NULL, news, PROT_READ|PROT_WRITE, MAP_SHARED, map->fd, 0);
+        if (mem != MAP_FAILED) munmap(ptr, map->size);
+        #endif
+    }
+    //restore old file size on failure, the old mapping is still intact
+    if (mem == MAP_FAILED) {
+        if (ptr) (void)!ftruncate(map->fd, (off_t)map->size);
+        return NULL;
+    }
+    map->size = news;
+    return mem;
+}
+static size_t dynarrHugeLength (const struct dynarrhuge* huge, size_t size) {
+    //round up to whole huge pages, so that none of them are split
+    size_t unit = (huge->flags & DYNARR_HUGE_1GB) ? (size_t)1 << 30 : (size_t)1 << 21;
+    return (size + unit-1)/unit*unit;
+}
+static void dynarrHugePlace (const struct dynarrhuge* huge, void* ptr, size_t len) {
+    //advise and bind before first touch, both are best effort
+    #ifdef MADV_HUGEPAGE
+    (void)madvise(ptr, len, MADV_HUGEPAGE);
+    #endif
+    #ifdef SYS_mbind
+    if (huge->nodes) {
+        unsigned long nodes = huge->nodes;
+        (void)syscall(SYS_mbind, ptr, len, (huge->flags & DYNARR_HUGE_INTERLEAVE) ? 3 : 2, &nodes, 8*sizeof(nodes)+1, 0);
+    }
+    #endif
+    (void)huge, (void)ptr, (void)len;
+}
+static void* dynarrHugeMap (const struct dynarrhuge* huge, size_t len) {
+    void* ptr = MAP_FAILED;
+    #ifdef MAP_ANONYMOUS
+    #ifdef MAP_HUGETLB
+    if (huge->flags & (DYNARR_HUGE_2MB|DYNARR_HUGE_1GB)) {
+        //try explicitly reserved huge pages first
+        int f = MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB;
+        #ifdef MAP_HUGE_SHIFT
+        f |= ((huge->flags & DYNARR_HUGE_1GB) ? 30 : 21) << MAP_HUGE_SHIFT;
+        #endif
+        ptr = mmap(NULL, len, PROT_READ|PROT_WRITE, f, -1, 0);
+    }
+    #endif
+    if (ptr == MAP_FAILED) ptr = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    #endif
+    if (ptr == MAP_FAILED) return NULL;
+    dynarrHugePlace(huge, ptr, len);
+    return ptr;
+}
+static void* dynarrHugeFunc (struct dynarralloc* allo, void* ptr, size_t olds, size_t news) {
+    struct dynarrhuge* huge = (struct dynarrhuge*)allo;
+    //which side of the threshold a block is on follows from its exact size
+    int obig = (ptr)&&(olds >= huge->thresh), nbig = (news)&&(news >= huge->thresh);
+    void* mem;
+    if (!news) {
+        if (obig) munmap(ptr, dynarrHugeLength(huge, olds));
+        else DYNARR_FFREE(ptr);
+        return NULL;
+    }
+    //small blocks go straight through
+    if ((!obig)&&(!nbig)) return DYNARR_REALLOC(ptr, news);
+    if (obig && nbig) {
+        //mapped blocks within the same huge pages stay in place
+        size_t olen = dynarrHugeLength(huge, olds), nlen = dynarrHugeLength(huge, news);
+        if (olen == nlen) return ptr;
+        #ifdef MREMAP_MAYMOVE
+        //let the kernel move the pages instead of copying them, falling back to copying if refused
+        mem = mremap(ptr, olen, nlen, MREMAP_MAYMOVE);
+        if (mem != MAP_FAILED) {
+            dynarrHugePlace(huge, mem, nlen);
+            return mem;
+        }
+        #endif
+    }
+    //move between heap and mapping, or between mappings, by copying
+    mem = nbig ? dynarrHugeMap(huge, dynarrHugeLength(huge, news)) : DYNARR_REALLOC(NULL, news);
+    if (!mem) return NULL;
+    if (ptr) {
+        memcpy(mem, ptr, (olds < news) ? olds : news);
+        if (obig) munmap(ptr, dynarrHugeLength(huge, olds));
+        else DYNARR_FFREE(ptr);
+    }
+    //return
+    return mem;
+}
+#endif
+//a view places the dynarr header into the reserved wire header bytes, which must not reach the fields in front
+typedef char dynarrWireFits[(DARR_HEAD <= DARR_WIRE - 32) ? 1 : -1];
+static uint64_t dynarrChecksum (const unsigned char* p, size_t n) {
+    //64 bit FNV-1a
+    uint64_t h = 0xcbf29ce484222325u;
+    for (size_t i = 0; i < n; i++) h = (h ^ p[i])*0x100000001b3u;
+    return h;
+}
+static DARRINT dynarrWireCheck (const unsigned char* head, DARRINT elem, size_t* size, int* alig, uint64_t* sum, size_t* wire) {
+    //check magic and version, a different byte order shows up as an unknown version
+    uint16_t vers, flag;
+    uint32_t el, al;
+    uint64_t count;
+    if (memcmp(head, "DARR", 4)) return -1;
+    memcpy(&vers, head+4, 2);
+    memcpy(&flag, head+6, 2);
+    memcpy(&el, head+8, 4);
+    memcpy(&al, head+12, 4);
+    memcpy(&count, head+16, 8);
+    memcpy(sum, head+24, 8);
+    if ((!vers)||(vers > DARR_WIRE_VERSION)||((uint32_t)elem != el)) return -1;
+    if ((al > DARR_WIRE)||(al & (al-1))) return -1;
+    //header size depends on version, elements must fit into both a dynarr and the given size after it
+    *wire = (vers == 1) ? DARR_WIRE_V1 : DARR_WIRE;
+    if (*size < *wire) return -1;
+    if ((count > (uint64_t)DARR_IMAX)||(count > (DARR_SMAX - DARR_WIRE)/(size_t)elem)) return -1;
+    if ((size_t)count*elem > *size - *wire) return -1;
+    *size = (size_t)count*elem;
+    *alig = (int)al;
+    if (!(flag & DYNARR_WIRE_CHECKSUM)) *sum = 0;
+    return (DARRINT)count;
+}
+static DARRINT dynarrGrowth (DARRINT capa, size_t elem, DARRINT n) {
+    //apply growth factor to current capacity, clamped to maximum
+    double g = (double)capa*(DYNARR_GROWTH);
+    DARRINT c = (g >= (double)DARR_IMAX) ? DARR_IMAX : (DARRINT)g;
+    //limit growth to maximum byte increment if there is one
+    if ((DYNARR_MAX_GROWTH > 0)&&((size_t)(c - capa) > (size_t)(DYNARR_MAX_GROWTH)/elem))
+        c = capa + (DARRINT)((size_t)(DYNARR_MAX_GROWTH)/elem);
+    //never go below minimum or requested capacity
+    if (c < DYNARR_MIN_CAPACITY) c = DYNARR_MIN_CAPACITY;
+    if (c < n) c = n;
+    //return
+    return c;
+}
+static DARRINT dynarrSortPlace (void* a, DARRINT j, int(*comp)(const void*, const void*)) {
+    //binary search for the first element greater than element j among the sorted elements before it
+    DARRINT lo = 0, hi = j;
+    while (lo < hi) {
+        DARRINT mid = lo + (hi-lo)/2;
+        if (DARR_COMP(comp, DARR_EPTR(a, mid), DARR_EPTR(a, j)) > 0) hi = mid;
+        else lo = mid+1;
+    }
+    //rotate element j down in front of the elements in between, a piece at a time for large elements
+    char temp[64];
+    for (size_t done = 0, e = (size_t)DARR_ELEM(a), n = e*(j-lo+1); (lo < j)&&(done < e);) {
+        size_t m = (e-done < sizeof(temp)) ? e-done : sizeof(temp);
+        memcpy(temp, DARR_EPTR(a, lo) + n-m, m);
+        memmove(DARR_EPTR(a, lo) + m, DARR_EPTR(a, lo), n-m);
+        memcpy(DARR_EPTR(a, lo), temp, m);
+        done += m;
+    }
+    //return
+    return lo;
+}
+static void dynarrSortSwap (char* a, char* b, size_t elem) {
+    //specialized swaps for common element sizes
+    if (elem == 4) {
+        uint32_t t; memcpy(&t, a, 4); memcpy(a, b, 4); memcpy(b, &t, 4);
+    } else if (elem == 8) {
+        uint64_t t; memcpy(&t, a, 8); memcpy(a, b, 8); memcpy(b, &t, 8);
+    } else if (elem == 16) {
+        uint64_t t[2]; memcpy(t, a, 16); memcpy(a, b, 16); memcpy(b, t, 16);
+    } else {
+        //generic swap in word sized chunks followed by remaining bytes
+        for (; elem >= 8; elem -= 8, a += 8, b += 8) {
+            uint64_t t; memcpy(&t, a, 8); memcpy(a, b, 8); memcpy(b, &t, 8);
+        }
+        for (; elem; elem--, a++, b++) {
+            char t = *a; *a = *b; *b = t;
+        }
+    }
+}
+static void dynarrSortSift (char* a, size_t r, size_t n, size_t elem, int(*comp)(const void*, const void*)) {
+    //sift element at r down the max-heap of n elements
+    for (size_t c; (c = 2*r+1) < n; r = c) {
+        if ((c+1 < n)&&(DARR_COMP(comp, a + c*elem, a + (c+1)*elem) < 0)) c++;
+        if (DARR_COMP(comp, a + r*elem, a + c*elem) >= 0) return;
+        dynarrSortSwap(a + r*elem, a + c*elem, elem);
+    }
+}
+static void dynarrSortIntro (char* a, size_t n, size_t elem, int(*comp)(const void*, const void*), int depth) {
+    //quicksort until partitions are small
+    while (n > 16) {
+        //heapsort if recursion is getting too deep
+        if (!depth--) {
+            for (size_t r = n/2; r-- > 0;) dynarrSortSift(a, r, n, elem, comp);
+            while (--n > 0) {
+                dynarrSortSwap(a, a + n*elem, elem);
+                dynarrSortSift(a, 0, n, elem, comp);
+            }
+            return;
+        }
+        //median of three moved to front as pivot, with smaller at middle and greater at end as sentinels
+        char* m = a + n/2*elem, *h = a + (n-1)*elem;
+        if (DARR_COMP(comp, m, a) < 0) dynarrSortSwap(m, a, elem);
+        if (DARR_COMP(comp, h, m) < 0) {
+            dynarrSortSwap(h, m, elem);
+            if (DARR_COMP(comp, m, a) < 0) dynarrSortSwap(m, a, elem);
+        }
+        dynarrSortSwap(a, m, elem);
+        //hoare partition around pivot
+        size_t i = 0, j = n;
+        for (;;) {
+            do i++; while (DARR_COMP(comp, a + i*elem, a) < 0);
+            do j--; while (DARR_COMP(comp, a, a + j*elem) < 0);
+            if (i >= j) break;
+            dynarrSortSwap(a + i*elem, a + j*elem, elem);
+        }
+        dynarrSortSwap(a, a + j*elem, elem);
+        //recurse into smaller partition and loop on larger one
+        if (j < n-j-1) {
+            dynarrSortIntro(a, j, elem, comp, depth);
+            a += (j+1)*elem;
+            n -= j+1;
+        } else {
+            dynarrSortIntro(a + (j+1)*elem, n-j-1, elem, comp, depth);
+            n = j;
+        }
+    }
+    //insertion sort what remains
+    for (size_t i = 1; i < n; i++)
+        for (size_t j = i; (j > 0)&&(DARR_COMP(comp, a + j*elem, a + (j-1)*elem) < 0); j--)
+            dynarrSortSwap(a + j*elem, a + (j-1)*elem, elem);
+}
+#define DARR_RADIX(U, N) \
+    static void N (U* a, U* b, size_t n, int kind) { \
+        const U top = (U)((U)1 << (8*sizeof(U)-1)); \
+        size_t hist[sizeof(U)][256] = {{0}}; \
+        /* map keys to unsigned bit patterns with the same order */ \
+        for (size_t i = 0; i < n; i++) { \
+            U k; memcpy(&k, &a[i], sizeof(U)); \
+            if (kind == DYNARR_RADIX_INT) k ^= top; \
+            else if (kind == DYNARR_RADIX_FLOAT) k = (k & top) ? (U)~k : (U)(k ^ top); \
+            a[i] = k; \
+            for (size_t d = 0; d < sizeof(U); d++) hist[d][(k >> 8*d) & 255]++; \
+        } \
+        /* scatter by each byte in turn, skipping bytes that are equal for all keys */ \
+        U* src = a, *dst = b; \
+        for (size_t d = 0; d < sizeof(U); d++) { \
+            if (hist[d][(src[0] >> 8*d) & 255] == n) continue; \
+            for (size_t k = 0, sum = 0; k < 256; k++) { \
+                size_t c = hist[d][k]; \
+                hist[d][k] = sum; \
+                sum += c; \
+            } \
+            for (size_t i = 0; i < n; i++) dst[hist[d][(src[i] >> 8*d) & 255]++] = src[i]; \
+            U* t = src; src = dst; dst = t; \
+        } \
+        /* map back to original keys, ending up in the dynarr */ \
+        for (size_t i = 0; i < n; i++) { \
+            U k = src[i]; \
+            if (kind == DYNARR_RADIX_INT) k ^= top; \
+            else if (kind == DYNARR_RADIX_FLOAT) k = (k & top) ? (U)(k ^ top) : (U)~k; \
+            memcpy(&a[i], &k, sizeof(U)); \
+        } \
+    }
+DARR_RADIX(uint8_t, dynarrRadix8)
+DARR_RADIX(uint16_t, dynarrRadix16)
+DARR_RADIX(uint32_t, dynarrRadix32)
+DARR_RADIX(uint64_t, dynarrRadix64)
+#define DARR_FIND(U, N) \
+    static DARRINT N (const char* p, DARRINT n, const void* k) { \
+        U key, e; memcpy(&key, k, sizeof(U)); \
+        for (DARRINT i = 0; i < n; i++) { \
+            memcpy(&e, p + i*sizeof(U), sizeof(U)); \
+            if (e == key) return i; \
+        } \
+        return -1; \
+    }
+DARR_FIND(uint16_t, dynarrFind16)
+DARR_FIND(uint32_t, dynarrFind32)
+DARR_FIND(uint64_t, dynarrFind64)
+static DARRINT dynarrFindRange (const char* p, DARRINT n, DARRINT elem, const void* k) {
+    //compare small elements directly as integers of matching width
+    switch (elem) {
+        case 1: {
+            const char* f = (const char*)memchr(p, *(const unsigned char*)k, n);
+            return f ? (DARRINT)(f - p) : -1;
+        }
+        case 2: return dynarrFind16(p, n, k);
+        case 4: return dynarrFind32(p, n, k);
+        case 8: return dynarrFind64(p, n, k);
+    }
+    //fall back to memcmp for everything else
+    for (DARRINT i = 0; i < n; i++)
+        if (!memcmp(k, p + (size_t)elem*i, elem)) return i;
+    return -1;
+}
+static DARRINT dynarrGallop (const char* p, DARRINT n, size_t e, int(*comp)(const void*, const void*), const void* k) {
+    //exponential search for a range ending in an element not less than key, then binary search within it
+    DARRINT lo = 0, step = 1;
+    while ((step <= n-lo)&&(DARR_COMP(comp, p + e*(lo+step-1), k) < 0)) {
+        lo += step;
+        if (step < DARR_IMAX/2) step *= 2;
+    }
+    DARRINT hi = (step-1 < n-lo) ? lo+step-1 : n;
+    while (lo < hi) {
+        DARRINT m = lo + (hi-lo)/2;
+        if (DARR_COMP(comp, p + e*m, k) < 0) lo = m+1;
+        else hi = m;
+    }
+    //return
+    return lo;
+}
+static void dynarrExecRun (struct dynarrexec* exec, void (*task)(void*, DARRINT), void* arg, DARRINT count) {
+    //run serially without a usable executor
+    if ((exec)&&(exec->run)&&(exec->threads > 1)&&(count > 1)) exec->run(exec, task, arg, count);
+    else for (DARRINT i = 0; i < count; i++) task(arg, i);
+}
+static int dynarrExecWidth (const struct dynarrexec* exec) {
+    //number of tasks worth running at once, 1 without a usable executor
+    if ((!exec)||(!exec->run)||(exec->threads < 2)) return 1;
+    return (exec->threads < DYNARR_MAX_THREADS) ? exec->threads : DYNARR_MAX_THREADS;
+}
+#ifdef DYNARR_THREADS
+struct dynarrstripe {
+    void (*task)(void*, DARRINT);
+    void* arg;
+    DARRINT from, step, count;
+};
+static void* dynarrThreadMain (void* p) {
+    //each thread runs every step-th task
+    struct dynarrstripe* s = (struct dynarrstripe*)p;
+    for (DARRINT i = s->from; i < s->count; i += s->step) s->task(s->arg, i);
+    return NULL;
+}
+static void dynarrThreadsRun (struct dynarrexec* exec, void (*task)(void*, DARRINT), void* arg, DARRINT count) {
+    int t = dynarrExecWidth(exec);
+    if (count < t) t = (int)count;
+    //at least one stripe, which the calling thread runs itself
+    if (t < 1) t = 1;
+    pthread_t th[DYNARR_MAX_THREADS];
+    struct dynarrstripe st[DYNARR_MAX_THREADS];
+    char live[DYNARR_MAX_THREADS];
+    for (int i = 0; i < t; i++) {
+        st[i].task = task;
+        st[i].arg = arg;
+        st[i].from = i;
+        st[i].step = t;
+        st[i].count = count;
+    }
+    //the calling thread takes the first stripe, and any stripe whose thread couldn't be created
+    for (int i = 1; i < t; i++) live[i] = !pthread_create(&th[i], NULL, dynarrThreadMain, &st[i]);
+    dynarrThreadMain(&st[0]);
+    for (int i = 1; i < t; i++) {
+        if (live[i]) pthread_join(th[i], NULL);
+        else dynarrThreadMain(&st[i]);
+    }
+}
+#endif
+static void dynarrHashPlace (struct dynarrhash* h, struct dynarrhashslot e) {
+    //robin hood insertion, taking the place of any entry closer to its home slot than the one being placed
+    for (size_t pos = e.hash & h->mask, dist = 0;; pos = (pos+1) & h->mask, dist++) {
+        struct dynarrhashslot* s = &h->slots[pos];
+        if (s->index < 0) {
+            *s = e;
+            return;
+        }
+        size_t d = (pos - (s->hash & h->mask)) & h->mask;
+        if (d < dist) {
+            struct dynarrhashslot t = *s;
+            *s = e;
+            e = t;
+            dist = d;
+        }
+    }
+}
+static int dynarrHashResize (struct dynarrhash* h, size_t capa) {
+    struct dynarrhashslot* old = h->slots;
+    size_t n = old ? h->mask+1 : 0;
+    //check for byte size overflow
+    if (capa > DARR_SMAX/sizeof(struct dynarrhashslot)) return -1;
+    struct dynarrhashslot* slots = (struct dynarrhashslot*)DYNARR_REALLOC(NULL, capa*sizeof(struct dynarrhashslot));
+    if (!slots) return -1;
+    for (size_t i = 0; i < capa; i++) slots[i].index = -1;
+    h->slots = slots;
+    h->mask = capa-1;
+    //reinsert using cached hashes, elements don't have to be touched
+    for (size_t i = 0; i < n; i++) if (old[i].index >= 0) dynarrHashPlace(h, old[i]);
+    if (old) DYNARR_FFREE(old);
+    return 0;
+}
+static size_t dynarrHashSlot (const struct dynarrhash* h, const void* a, DARRINT i) {
+    //probe for the entry of element i, which must be in the table
+    size_t hash = h->hash(DARR_EPTR(a, i)), pos = hash & h->mask;
+    while (h->slots[pos].index != i) pos = (pos+1) & h->mask;
+    return pos;
+}
+static void dynarrHashErase (struct dynarrhash* h, size_t pos) {
+    //backward shift deletion, pulling following entries one closer to their home slot
+    for (size_t next = (pos+1) & h->mask;; pos = next, next = (next+1) & h->mask) {
+        struct dynarrhashslot* s = &h->slots[next];
+        if ((s->index < 0)||(((next - (s->hash & h->mask)) & h->mask) == 0)) break;
+        h->slots[pos] = *s;
+    }
+    h->slots[pos].index = -1;
+    h->count--;
+}
+static size_t dynarrSoaLength (size_t elem, DARRINT c) {
+    //bytes taken by a column of given capacity, padded so the next one stays aligned
+    return (elem*c + DARR_SOA_ALIG-1)/DARR_SOA_ALIG*DARR_SOA_ALIG;
+}
+static int dynarrSoaCheck (int cols, const size_t* elem, DARRINT c) {
+    //check that the total byte size can't overflow, padding included
+    size_t row = 0;
+    for (int k = 0; k < cols; k++) row += elem[k];
+    size_t fixed = DARR_SOA_BODY(cols) + DARR_SOA_ALIG*(cols+1);
+    return (c < 0)||(fixed < DARR_SOA_BODY(cols))||((row)&&((size_t)c > (DARR_SMAX - fixed)/row));
+}
+static void dynarrSoaLayout (const struct dynarrsoa* s, DARRINT c, size_t* pos) {
+    //columns follow the header one after another
+    pos[0] = DARR_SOA_BODY(s->cols);
+    for (int k = 1; k < s->cols; k++) pos[k] = pos[k-1] + dynarrSoaLength(DARR_SOA_ELEM(s)[k-1], c);
+}
+static int dynarrSoaRealloc (struct dynarrsoa** s, DARRINT c) {
+    int cols = (*s)->cols, padd = (*s)->padd;
+    size_t body = DARR_SOA_BODY(cols);
+    if (dynarrSoaCheck(cols, DARR_SOA_ELEM(*s), c)) return -1;
+    //keep a copy of the header next to the new layout, as it may be overwritten while moving columns
+    size_t* pos = (size_t*)DYNARR_REALLOC(NULL, body + sizeof(size_t)*cols);
+    if (!pos) return -1;
+    struct dynarrsoa* h = (struct dynarrsoa*)(pos + cols);
+    memcpy(h, *s, body);
+    dynarrSoaLayout(*s, c, pos);
+    size_t size = pos[cols-1] + dynarrSoaLength(DARR_SOA_ELEM(*s)[cols-1], c) + DARR_SOA_ALIG-1;
+    char* ptr = (char*)DYNARR_REALLOC((char*)*s - padd, size);
+    if (!ptr) {
+        DYNARR_FFREE(pos);
+        return -1;
+    }
+    int npad = (int)((DARR_SOA_ALIG - (uintptr_t)ptr%DARR_SOA_ALIG)%DARR_SOA_ALIG);
+    //move columns to their new positions, those moving down in ascending and those moving up in descending order
+    //as shifts only ever grow from one column to the next, no column then overwrites another that hasn't moved yet
+    size_t* opos = DARR_SOA_POS(h), *elem = DARR_SOA_ELEM(h);
+    for (int k = 0; k < cols; k++)
+        if (npad + pos[k] < padd + opos[k]) memmove(ptr + npad + pos[k], ptr + padd + opos[k], elem[k]*h->size);
+    for (int k = cols; k-- > 0;)
+        if (npad + pos[k] > padd + opos[k]) memmove(ptr + npad + pos[k], ptr + padd + opos[k], elem[k]*h->size);
+    //put header back in front of the columns
+    *s = (struct dynarrsoa*)(ptr + npad);
+    memcpy(*s, h, body);
+    memcpy(DARR_SOA_POS(*s), pos, sizeof(size_t)*cols);
+    (*s)->capa = c;
+    (*s)->padd = npad;
+    DYNARR_FFREE(pos);
+    //return
+    return 0;
+}
+static void dynarrSoaReset (struct dynarrsoa* s) {
+    //move rows back to the start of each column, which can't overlap across columns
+    for (int k = 0; k < s->cols; k++) {
+        char* col = (char*)s + DARR_SOA_POS(s)[k];
+        memmove(col, col + DARR_SOA_ELEM(s)[k]*s->offs, DARR_SOA_ELEM(s)[k]*s->size);
+    }
+    s->offs = 0;
+}
+struct dynarrsortpar {
+    char* src, *dst;
+    size_t elem;
+    int(*comp)(const void*, const void*);
+    const size_t* bnds;
+    size_t runs, width, parts;
+    uint64_t* comps;
+};
+static void dynarrSortChunk (void* p, DARRINT i) {
+    struct dynarrsortpar* s = (struct dynarrsortpar*)p;
+    size_t n = s->bnds[i+1] - s->bnds[i];
+    int depth = 0;
+    for (size_t m = n; m > 1; m /= 2) depth += 2;
+    DARR_STAT_MARK(c0);
+    dynarrSortIntro(s->src + s->bnds[i]*s->elem, n, s->elem, s->comp, depth);
+    DARR_STAT_TASK(s, i, c0);
+}
+static void dynarrSortMerge (void* p, DARRINT t) {
+    struct dynarrsortpar* s = (struct dynarrsortpar*)p;
+    size_t e = s->elem, pair = (size_t)t/s->parts, part = (size_t)t%s->parts;
+    //runs of this pair, the second one may be empty
+    size_t r0 = 2*pair*s->width, r1 = r0 + s->width, r2 = r1 + s->width;
+    if (r1 > s->runs) r1 = s->runs;
+    if (r2 > s->runs) r2 = s->runs;
+    const char* a = s->src + s->bnds[r0]*e, *b = s->src + s->bnds[r1]*e;
+    size_t na = s->bnds[r1] - s->bnds[r0], nb = s->bnds[r2] - s->bnds[r1];
+    //this part's share of the merged output
+    size_t d0 = (na+nb)*part/s->parts, d1 = (na+nb)*(part+1)/s->parts, i[2];
+    DARR_STAT_MARK(c0);
+    for (int k = 0; k < 2; k++) {
+        //find how many elements of the first run come before output position d, by binary search along the diagonal
+        size_t d = k ? d1 : d0, lo = (d > nb) ? d-nb : 0, hi = (d < na) ? d : na;
+        while (lo < hi) {
+            size_t m = lo + (hi-lo)/2;
+            if (DARR_COMP(s->comp, a + m*e, b + (d-m-1)*e) > 0) hi = m;
+            else lo = m+1;
+        }
+        i[k] = lo;
+    }
+    //merge the two slices, taking from the first run on ties
+    const char* x = a + i[0]*e, *xe = a + i[1]*e, *y = b + (d0-i[0])*e, *ye = b + (d1-i[1])*e;
+    char* o = s->dst + (s->bnds[r0] + d0)*e;
+    while ((x < xe)&&(y < ye)) {
+        if (DARR_COMP(s->comp, y, x) < 0) { memcpy(o, y, e); y += e; }
+        else { memcpy(o, x, e); x += e; }
+        o += e;
+    }
+    memcpy(o, x, xe-x);
+    memcpy(o + (xe-x), y, ye-y);
+    DARR_STAT_TASK(s, t, c0);
+}
+struct dynarrfindpar {
+    const char* p;
+    const void* k;
+    DARRINT elem, base, part, end;
+    DARRINT* hits;
+};
+struct dynarrbulk {
+    char* p;
+    size_t elem;
+    DARRINT n, parts;
+    void (*map)(void*, void*);
+    void (*fold)(void*, const void*, void*);
+    int (*keep)(const void*, void*);
+    void* ctx, *accs;
+    size_t accsize;
+    DARRINT* kept;
+};
+static void dynarrBulkInit (struct dynarrbulk* b, const void* a, const struct dynarrexec* exec, void* ctx) {
+    memset(b, 0, sizeof(struct dynarrbulk));
+    b->p = DARR_EPTR(a, 0);
+    b->elem = (size_t)DARR_ELEM(a);
+    b->n = DARR_SIZE(a);
+    b->ctx = ctx;
+    //one chunk per thread, but never so small that splitting isn't worth it
+    DARRINT t = dynarrExecWidth(exec), k = b->n/DARR_PAR_MIN;
+    b->parts = (k < 1) ? 1 : (k < t) ? k : t;
+}
+static void dynarrMapChunk (void* p, DARRINT i) {
+    struct dynarrbulk* b = (struct dynarrbulk*)p;
+    char* e = DARR_CHUNK(b, i), *end = DARR_CHUNK(b, i+1);
+    for (; e < end; e += b->elem) b->map(e, b->ctx);
+}
+static void dynarrReduceChunk (void* p, DARRINT i) {
+    struct dynarrbulk* b = (struct dynarrbulk*)p;
+    char* e = DARR_CHUNK(b, i), *end = DARR_CHUNK(b, i+1);
+    char* acc = (char*)b->accs + b->accsize*i;
+    for (; e < end; e += b->elem) b->fold(acc, e, b->ctx);
+}
+static void dynarrFilterChunk (void* p, DARRINT i) {
+    struct dynarrbulk* b = (struct dynarrbulk*)p;
+    char* e = DARR_CHUNK(b, i), *end = DARR_CHUNK(b, i+1);
+    //stable compaction to the front of the chunk, elements already in place aren't copied
+    char* w = e;
+    for (; e < end; e += b->elem) {
+        if (!b->keep(e, b->ctx)) continue;
+        if (w != e) memcpy(w, e, b->elem);
+        w += b->elem;
+    }
+    b->kept[i] = (DARRINT)((size_t)(w - DARR_CHUNK(b, i))/b->elem);
+}
+static void dynarrFindChunk (void* p, DARRINT i) {
+    struct dynarrfindpar* f = (struct dynarrfindpar*)p;
+    //offsets are checked against what is left before adding them, so nothing can overflow
+    DARRINT off = i*f->part, left = f->end - f->base, r = -1;
+    if (off < left) {
+        DARRINT n = (left - off < f->part) ? left - off : f->part;
+        r = dynarrFindRange(f->p + (size_t)f->elem*(f->base + off), n, f->elem, f->k);
+    }
+    f->hits[i] = (r < 0) ? -1 : f->base + off + r;
+}
 
 //public functions
-DARRDEF void* dynarrNew (int elem) {
-    //allocate new dynarr with space for one element
-    struct dynarr* darr = (struct dynarr*)DYNARR_ZALLOC(sizeof(struct dynarr) + elem);
+DARRDEF void* dynarrNew (DARRINT elem) {
+    return dynarrNewEx(elem, DYNARR_MIN_CAPACITY, 0, NULL);
+}
+DARRDEF void* dynarrNewEx (DARRINT elem, DARRINT c, int alig, struct dynarralloc* allo) {
+    DARR_ASSERT(!(alig & (alig-1)));
+    //check for byte size overflow
+    if ((c < 0)||((size_t)c > (DARR_SMAX - DARR_HEAD - DARR_SLACK(alig))/elem)) return NULL;
+    //allocate new dynarr with space for c elements plus alignment slack
+    char* ptr;
+    if (allo) {
+        //allocator memory is not zeroed, so clear the part that may hold the header
+        ptr = (char*)allo->func(allo, NULL, 0, DARR_BYTES(elem, c, alig));
+        if (ptr) memset(ptr, 0, DARR_HEAD + DARR_SLACK(alig));
+    } else {
+        ptr = (char*)DYNARR_ZALLOC(DARR_BYTES(elem, c, alig));
+    }
     //check for allocation failure
-    if (!darr) return NULL;
+    if (!ptr) return NULL;
+    //place header so that the first element is aligned
+    int padd = dynarrPadding(ptr, alig);
+    struct dynarr* darr = (struct dynarr*)(ptr + padd);
     //fill in values
-    darr->capa = 1;
+    darr->capa = c;
+    darr->elem = elem;
+    darr->alig = alig;
+    darr->padd = padd;
+    darr->allo = allo;
+    #ifdef DYNARR_STATS
+    dynarrStatsPeak(ptr + padd + DARR_HEAD, DARR_BYTES(elem, c, alig));
+    #endif
+    //return
+    return ptr + padd + DARR_HEAD;
+}
+DARRDEF void* dynarrNewInline (DARRINT elem, int alig, void* buff, size_t size) {
+    DARR_ASSERT(!(alig & (alig-1)));
+    //place header so that the first element is aligned, to at least 16 bytes
+    int padd = dynarrPadding((char*)buff, (alig > 16) ? alig : 16);
+    if (size < padd + DARR_HEAD) return NULL;
+    struct dynarr* darr = (struct dynarr*)((char*)buff + padd);
+    //fill in values, capacity is whatever fits into the rest of the buffer
+    memset((void*)darr, 0, sizeof(struct dynarr));
+    darr->capa = (DARRINT)((size - padd - DARR_HEAD)/elem);
     darr->elem = elem;
+    darr->alig = alig;
+    darr->padd = padd;
+    darr->flag = DARR_FLAG_BORROW;
     //return
-    return &darr[1];
+    return (char*)darr + DARR_HEAD;
 }
 DARRDEF void dynarrFree (void* a) {
-    DYNARR_FFREE(&DARR_RAW(a));
+    struct dynarralloc* allo = DARR_RAW(a).allo;
+    #ifdef DYNARR_ATOMIC
+    //storage that is still held by snapshots is freed by whichever lets go of it last
+    if ((atomic_load_explicit(&DARR_RAW(a).refs, memory_order_acquire))&&
+        (atomic_fetch_sub_explicit(&DARR_RAW(a).refs, 1, memory_order_acq_rel) > 0)) return;
+    #endif
+    if (DARR_RAW(a).flag & DARR_FLAG_BORROW) return;
+    DARR_STAT_FREE(a, DARR_BYTES(DARR_ELEM(a), DARR_CAPA(a), DARR_RAW(a).alig));
+    if (allo) allo->func(allo, DARR_BASE(a), DARR_BYTES(DARR_ELEM(a), DARR_CAPA(a), DARR_RAW(a).alig), 0);
+    else DYNARR_FFREE(DARR_BASE(a));
+}
+DARRDEF void dynarrArenaInit (struct dynarrarena* arena, void* data, size_t size) {
+    arena->base.func = dynarrArenaFunc;
+    arena->data = (char*)data;
+    arena->size = size;
+    arena->used = arena->last = 0;
+}
+DARRDEF void dynarrArenaReset (struct dynarrarena* arena) {
+    arena->used = arena->last = 0;
+}
+DARRDEF void dynarrPoolInit (struct dynarrpool* pool) {
+    memset(pool, 0, sizeof(struct dynarrpool));
+    pool->base.func = dynarrPoolFunc;
+}
+DARRDEF void dynarrPoolDestroy (struct dynarrpool* pool) {
+    //free slabs one by one, each starts with a pointer to the next
+    while (pool->slabs) {
+        void* next = *(void**)pool->slabs;
+        DYNARR_FFREE(pool->slabs);
+        pool->slabs = next;
+    }
+    memset(pool->free, 0, sizeof(pool->free));
 }
 DARRDEF int dynarrGrow (void** a) {
     //grow if currently at capacity
-    if (DARR_OFFS(*a)+DARR_SIZE(*a) == DARR_CAPA(*a))
-        if (DARR_OFFS(*a) >= DARR_SIZE(*a)) {
-            //double the available capacity by offset reset
-            memcpy(*a, DARR_EPTR(*a, 0), DARR_ELEM(*a)*DARR_SIZE(*a));
-            DARR_OFFS(*a) = 0;
-        } else {
-            //double the available capacity by reallocation
-            void* ptr = DYNARR_REALLOC(&DARR_RAW(*a), sizeof(struct dynarr) + DARR_ELEM(*a)*DARR_CAPA(*a)*2);
-            //check for realloc failure
-            if (!ptr) return -1;
-            //assign to dynarr pointer
-            *a = &((struct dynarr*)ptr)[1];
-            //update allocated capacity
-            DARR_CAPA(*a) *= 2;
+    return (DARR_OFFS(*a)+DARR_SIZE(*a) == DARR_CAPA(*a)) ? dynarrReserve(a, 1) : 0;
+}
+DARRDEF int dynarrGrowFront (void** a) {
+    //use space left in front by the offset if there is any
+    if (DARR_OFFS(*a)) return 0;
+    DARRINT s = DARR_SIZE(*a), h = s/2 + 1;
+    //grow first if re-centering would leave less than half the size free, so this only happens every O(n) pushes
+    if (DARR_CAPA(*a)-s < h) {
+        if (s > DARR_IMAX-h) return -1;
+        if (dynarrRealloc(a, dynarrGrowth(DARR_CAPA(*a), (size_t)DARR_ELEM(*a), s+h))) return -1;
+    }
+    //re-center elements, giving the larger half of the free space to the front
+    DARRINT f = DARR_CAPA(*a)-s, o = f - f/2;
+    memmove(DARR_EPTR(*a, o), *a, (size_t)DARR_ELEM(*a)*s);
+    DARR_STAT(*a, compacted, (size_t)DARR_ELEM(*a)*s);
+    DARR_OFFS(*a) = o;
+    //return
+    return 0;
+}
+DARRDEF int dynarrReserve (void** a, DARRINT n) {
+    DARR_ASSERT(n >= 0);
+    //check if there is enough space at the end already
+    if (n <= DARR_CAPA(*a)-DARR_OFFS(*a)-DARR_SIZE(*a)) return 0;
+    //reset offset if it takes up at least as much space as the elements
+    if ((DARR_OFFS(*a))&&(DARR_OFFS(*a) >= DARR_SIZE(*a))) {
+        //non-overlapping so memcpy is fine
+        memcpy(*a, DARR_EPTR(*a, 0), (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
+        DARR_STAT(*a, compacted, (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
+        DARR_OFFS(*a) = 0;
+        //check if offset reset freed up enough space
+        if (n <= DARR_CAPA(*a)-DARR_SIZE(*a)) return 0;
+    }
+    //check for capacity overflow
+    if (n > DARR_IMAX-DARR_OFFS(*a)-DARR_SIZE(*a)) return -1;
+    //grow capacity by reallocation according to growth policy
+    return dynarrRealloc(a, dynarrGrowth(DARR_CAPA(*a), (size_t)DARR_ELEM(*a), DARR_OFFS(*a)+DARR_SIZE(*a)+n));
+}
+DARRDEF DARRINT dynarrAppend (void** a, const void* p, DARRINT n) {
+    //make space for all new elements at once
+    if (dynarrReserve(a, n)) return -1;
+    //copy elements in as a single block
+    memcpy(DARR_EPTR(*a, DARR_SIZE(*a)), p, (size_t)DARR_ELEM(*a)*n);
+    DARR_SIZE(*a) += n;
+    //return index of first new element
+    return DARR_SIZE(*a)-n;
+}
+DARRDEF int dynarrSlotmapInit (struct dynarrslotmap* m, DARRINT elem) {
+    m->dense = dynarrNew(elem);
+    m->owner = (uint32_t*)dynarrNew(sizeof(uint32_t));
+    m->slots = (struct dynarrslot*)dynarrNew(sizeof(struct dynarrslot));
+    m->free = UINT32_MAX;
+    if ((m->dense)&&(m->owner)&&(m->slots)) return 0;
+    //clean up whatever did get allocated
+    if (m->dense) dynarrFree(m->dense);
+    if (m->owner) dynarrFree(m->owner);
+    if (m->slots) dynarrFree(m->slots);
+    return -1;
+}
+DARRDEF void dynarrSlotmapFree (struct dynarrslotmap* m) {
+    dynarrFree(m->dense);
+    dynarrFree(m->owner);
+    dynarrFree(m->slots);
+}
+DARRDEF uint64_t dynarrSlotmapInsert (struct dynarrslotmap* m, const void* p) {
+    //slot indices have to fit into the lower half of a handle, with UINT32_MAX marking the end of the free list
+    if ((m->free == UINT32_MAX)&&((uint64_t)DARR_SIZE(m->slots) >= UINT32_MAX)) return 0;
+    //reserve everything first, so nothing has to be undone on failure
+    if ((dynarrReserve(&m->dense, 1))||(dynarrReserve((void**)&m->owner, 1))) return 0;
+    if ((m->free == UINT32_MAX)&&(dynarrReserve((void**)&m->slots, 1))) return 0;
+    //take a slot from the free list, or make a new one with generation 1
+    uint32_t s = m->free;
+    if (s == UINT32_MAX) {
+        s = (uint32_t)DARR_SIZE(m->slots)++;
+        m->slots[s].gen = 1;
+    } else {
+        m->free = m->slots[s].index;
+    }
+    //append element to the dense array, remembering which slot owns it
+    DARRINT i = dynarrAppend(&m->dense, p, 1);
+    m->owner[DARR_SIZE(m->owner)++] = s;
+    m->slots[s].index = (uint32_t)i;
+    //return
+    return (uint64_t)m->slots[s].gen << 32 | s;
+}
+DARRDEF int dynarrSlotmapRemove (struct dynarrslotmap* m, uint64_t h) {
+    uint32_t s = (uint32_t)h;
+    if (!dynarrSlotmapGet(m, h)) return -1;
+    //move last element into the gap, pointing its slot at the new position
+    uint32_t i = m->slots[s].index, last = (uint32_t)--DARR_SIZE(m->dense);
+    if (i != last) {
+        memcpy(DARR_EPTR(m->dense, i), DARR_EPTR(m->dense, last), DARR_ELEM(m->dense));
+        m->owner[i] = m->owner[last];
+        m->slots[m->owner[i]].index = i;
+    }
+    DARR_SIZE(m->owner)--;
+    //invalidate outstanding handles and put slot on the free list, generation 0 is skipped to keep handle 0 invalid
+    if (!++m->slots[s].gen) m->slots[s].gen = 1;
+    m->slots[s].index = m->free;
+    m->free = s;
+    //return
+    return 0;
+}
+DARRDEF void* dynarrSlotmapGet (struct dynarrslotmap* m, uint64_t h) {
+    uint32_t s = (uint32_t)h;
+    //free slots never match, as their generation moved on when they were freed
+    if ((s >= (uint64_t)DARR_SIZE(m->slots))||(m->slots[s].gen != (uint32_t)(h >> 32))) return NULL;
+    return DARR_EPTR(m->dense, m->slots[s].index);
+}
+DARRDEF int dynarrSegInit (struct dynarrseg* s, DARRINT elem, DARRINT chunk) {
+    //default to chunks of about 64KB
+    if (chunk <= 0) chunk = (elem < 65536) ? 65536/elem : 1;
+    //round chunk size up to a power of two, so that indexing is a shift and a mask
+    s->shift = 0;
+    while (((DARRINT)1 << s->shift) < chunk) {
+        if (s->shift >= (int)(8*sizeof(DARRINT))-2) return -1;
+        s->shift++;
+    }
+    if (((size_t)1 << s->shift) > DARR_SMAX/elem) return -1;
+    s->elem = elem;
+    s->offs = s->size = 0;
+    s->chunks = (void**)dynarrNew(sizeof(void*));
+    return s->chunks ? 0 : -1;
+}
+DARRDEF void dynarrSegFree (struct dynarrseg* s) {
+    for (DARRINT i = 0; i < DARR_SIZE(s->chunks); i++) DYNARR_FFREE(s->chunks[DARR_OFFS(s->chunks)+i]);
+    dynarrFree(s->chunks);
+}
+DARRDEF int dynarrSegReserve (struct dynarrseg* s, DARRINT n) {
+    DARR_ASSERT(n >= 0);
+    //check for capacity overflow
+    if (n > DARR_IMAX-s->offs-s->size) return -1;
+    //number of chunks needed to hold that many elements after the offset
+    DARRINT end = s->offs+s->size+n, need = (end >> s->shift) + ((end & (((DARRINT)1 << s->shift)-1)) != 0);
+    //add chunks one by one, existing ones never move
+    while (DARR_SIZE(s->chunks) < need) {
+        void* c = DYNARR_REALLOC(NULL, (size_t)s->elem << s->shift);
+        if (!c) return -1;
+        if (dynarrAppend((void**)&s->chunks, &c, 1) < 0) {
+            DYNARR_FFREE(c);
+            return -1;
         }
+    }
     //return
     return 0;
 }
-DARRDEF int dynarrResize (void** a, int s) {
+static void dynarrSegRelease (struct dynarrseg* s) {
+    //free the first chunk once all of its elements have been dequeued
+    if (s->offs >> s->shift) {
+        DYNARR_FFREE(s->chunks[DARR_OFFS(s->chunks)]);
+        DARR_OFFS(s->chunks)++;
+        DARR_SIZE(s->chunks)--;
+        s->offs -= (DARRINT)1 << s->shift;
+    }
+}
+DARRDEF void* dynarrSegDequeue (struct dynarrseg* s) {
+    //release the previous first chunk only now, as the previous result pointed into it
+    dynarrSegRelease(s);
+    void* p = DARR_SEG_PTR(s, 0);
+    s->offs++;
+    s->size--;
+    //return
+    return p;
+}
+DARRDEF void dynarrSegShrink (struct dynarrseg* s) {
+    if (!s->size) s->offs = 0;
+    dynarrSegRelease(s);
+    //free trailing chunks past the last element
+    DARRINT end = s->offs+s->size, used = (end >> s->shift) + ((end & (((DARRINT)1 << s->shift)-1)) != 0);
+    while (DARR_SIZE(s->chunks) > used) DYNARR_FFREE(s->chunks[DARR_OFFS(s->chunks) + --DARR_SIZE(s->chunks)]);
+    //shrink chunk pointers as well, failure to do so is harmless
+    if (!DARR_SIZE(s->chunks)) DARR_OFFS(s->chunks) = 0;
+    dynarrShrink((void**)&s->chunks);
+}
+DARRDEF void dynarrHashInit (struct dynarrhash* h, size_t (*hash)(const void*), int (*comp)(const void*, const void*)) {
+    memset(h, 0, sizeof(struct dynarrhash));
+    h->hash = hash;
+    h->comp = comp;
+}
+DARRDEF void dynarrHashFree (struct dynarrhash* h) {
+    if (h->slots) DYNARR_FFREE(h->slots);
+    h->slots = NULL;
+    h->mask = h->count = 0;
+}
+DARRDEF int dynarrHashBuild (struct dynarrhash* h, const void* a) {
+    //size table for all elements at once, at most 3/4 full
+    size_t n = (size_t)DARR_SIZE(a), capa = 16;
+    while (capa/4*3 < n) capa *= 2;
+    dynarrHashFree(h);
+    if (dynarrHashResize(h, capa)) return -1;
+    for (DARRINT i = 0; i < DARR_SIZE(a); i++) {
+        struct dynarrhashslot e = {h->hash(DARR_EPTR(a, i)), i};
+        dynarrHashPlace(h, e);
+    }
+    h->count = n;
+    return 0;
+}
+DARRDEF DARRINT dynarrHashFind (const struct dynarrhash* h, const void* a, const void* k) {
+    if (!h->slots) return -1;
+    size_t hash = h->hash(k);
+    for (size_t pos = hash & h->mask, dist = 0;; pos = (pos+1) & h->mask, dist++) {
+        const struct dynarrhashslot* s = &h->slots[pos];
+        //an empty slot, or an entry closer to home than we are, means the key isn't there
+        if ((s->index < 0)||(((pos - (s->hash & h->mask)) & h->mask) < dist)) return -1;
+        if ((s->hash == hash)&&(!h->comp(k, DARR_EPTR(a, s->index)))) return s->index;
+    }
+}
+DARRDEF DARRINT dynarrHashAdd (struct dynarrhash* h, void* a) {
+    //add last element, growing the table once it would get more than 3/4 full
+    DARRINT i = DARR_SIZE(a)-1;
+    if ((!h->slots)||(h->count+1 > (h->mask+1)/4*3)) {
+        if ((!h->slots) ? dynarrHashResize(h, 16) : ((h->mask+1 > DARR_SMAX/2)||(dynarrHashResize(h, 2*(h->mask+1))))) {
+            //undo the push so dynarr and index stay consistent
+            DARR_SIZE(a)--;
+            return -1;
+        }
+    }
+    struct dynarrhashslot e = {h->hash(DARR_EPTR(a, i)), i};
+    dynarrHashPlace(h, e);
+    h->count++;
+    return i;
+}
+DARRDEF void dynarrHashDitch (struct dynarrhash* h, const void* a, DARRINT i) {
+    //drop entry of element i, then renumber the entry of the last element that takes its place
+    DARRINT last = DARR_SIZE(a)-1;
+    dynarrHashErase(h, dynarrHashSlot(h, a, i));
+    if (i != last) h->slots[dynarrHashSlot(h, a, last)].index = i;
+}
+DARRDEF void dynarrHashRemove (struct dynarrhash* h, const void* a, DARRINT i) {
+    //drop entry of element i, then shift down all indices after it
+    dynarrHashErase(h, dynarrHashSlot(h, a, i));
+    for (size_t p = 0; p <= h->mask; p++) if (h->slots[p].index > i) h->slots[p].index--;
+}
+DARRDEF struct dynarrsoa* dynarrSoaNew (int cols, const size_t* elem, DARRINT c) {
+    DARR_ASSERT(cols > 0);
+    if (dynarrSoaCheck(cols, elem, c)) return NULL;
+    //allocate header and all columns at once, plus slack for alignment
+    size_t size = DARR_SOA_BODY(cols) + DARR_SOA_ALIG-1;
+    for (int k = 0; k < cols; k++) size += dynarrSoaLength(elem[k], c);
+    char* ptr = (char*)DYNARR_ZALLOC(size);
+    if (!ptr) return NULL;
+    int padd = (int)((DARR_SOA_ALIG - (uintptr_t)ptr%DARR_SOA_ALIG)%DARR_SOA_ALIG);
+    struct dynarrsoa* s = (struct dynarrsoa*)(ptr + padd);
+    //fill in values
+    s->capa = c;
+    s->cols = cols;
+    s->padd = padd;
+    memcpy(DARR_SOA_ELEM(s), elem, sizeof(size_t)*cols);
+    dynarrSoaLayout(s, c, DARR_SOA_POS(s));
+    //return
+    return s;
+}
+DARRDEF void dynarrSoaFree (struct dynarrsoa* s) {
+    DYNARR_FFREE((char*)s - s->padd);
+}
+DARRDEF int dynarrSoaReserve (struct dynarrsoa** s, DARRINT n) {
+    DARR_ASSERT(n >= 0);
+    //check if there is enough space at the end already
+    if (n <= (*s)->capa-(*s)->offs-(*s)->size) return 0;
+    //reset offset before growing, so it doesn't get moved along
+    if ((*s)->offs) {
+        dynarrSoaReset(*s);
+        if (n <= (*s)->capa-(*s)->size) return 0;
+    }
+    //check for capacity overflow
+    if (n > DARR_IMAX-(*s)->size) return -1;
+    //grow all columns by a single reallocation according to growth policy
+    size_t row = 0;
+    for (int k = 0; k < (*s)->cols; k++) row += DARR_SOA_ELEM(*s)[k];
+    return dynarrSoaRealloc(s, dynarrGrowth((*s)->capa, row ? row : 1, (*s)->size+n));
+}
+DARRDEF DARRINT dynarrSoaResize (struct dynarrsoa** s, DARRINT n) {
+    if (n <= (*s)->size) {
+        //simply shrink size, resetting offset if shrunk to 0
+        (*s)->size = (n < 0) ? 0 : n;
+        if (!(*s)->size) (*s)->offs = 0;
+        return (*s)->size;
+    }
+    //make space, then zero new rows in every column
+    if (dynarrSoaReserve(s, n-(*s)->size)) return -1;
+    for (int k = 0; k < (*s)->cols; k++) {
+        size_t e = DARR_SOA_ELEM(*s)[k];
+        memset((char*)*s + DARR_SOA_POS(*s)[k] + e*((*s)->offs+(*s)->size), 0, e*(n-(*s)->size));
+    }
+    (*s)->size = n;
+    //return
+    return n;
+}
+DARRDEF void dynarrSoaDitch (struct dynarrsoa* s, DARRINT i) {
+    DARR_ASSERT((i >= 0)&&(i < s->size));
+    //move last row into the removed one, column by column
+    DARRINT last = --s->size;
+    if (i != last) {
+        for (int k = 0; k < s->cols; k++) {
+            size_t e = DARR_SOA_ELEM(s)[k];
+            char* col = (char*)s + DARR_SOA_POS(s)[k] + e*s->offs;
+            memcpy(col + e*i, col + e*last, e);
+        }
+    }
+    if (!s->size) s->offs = 0;
+}
+DARRDEF DARRINT dynarrInsertN (void** a, DARRINT i, const void* p, DARRINT n) {
+    DARR_ASSERT((i >= 0)&&(i <= DARR_SIZE(*a))&&(n >= 0));
+    if ((DARR_OFFS(*a) >= n)&&(i < DARR_SIZE(*a)/2)) {
+        //fewer elements in front, so shift those back into the offset
+        DARR_OFFS(*a) -= n;
+        memmove(DARR_EPTR(*a, 0), DARR_EPTR(*a, n), (size_t)DARR_ELEM(*a)*i);
+        DARR_STAT(*a, moved, (size_t)DARR_ELEM(*a)*i);
+    } else {
+        //otherwise make space for all new elements at once and shift the rest forward
+        if (dynarrReserve(a, n)) return -1;
+        memmove(DARR_EPTR(*a, i+n), DARR_EPTR(*a, i), (size_t)DARR_ELEM(*a)*(DARR_SIZE(*a)-i));
+        DARR_STAT(*a, moved, (size_t)DARR_ELEM(*a)*(DARR_SIZE(*a)-i));
+    }
+    //copy elements in as a single block
+    if (p) memcpy(DARR_EPTR(*a, i), p, (size_t)DARR_ELEM(*a)*n);
+    DARR_SIZE(*a) += n;
+    //return index of first new element
+    return i;
+}
+DARRDEF void dynarrRemoveRange (void** a, DARRINT i, DARRINT n) {
+    DARR_ASSERT((i >= 0)&&(n >= 0)&&(n <= DARR_SIZE(*a)-i));
+    if (i < DARR_SIZE(*a)-i-n) {
+        //fewer elements in front, so shift those forward and grow the offset
+        memmove(DARR_EPTR(*a, n), DARR_EPTR(*a, 0), (size_t)DARR_ELEM(*a)*i);
+        DARR_STAT(*a, moved, (size_t)DARR_ELEM(*a)*i);
+        DARR_OFFS(*a) += n;
+    } else {
+        memmove(DARR_EPTR(*a, i), DARR_EPTR(*a, i+n), (size_t)DARR_ELEM(*a)*(DARR_SIZE(*a)-i-n));
+        DARR_STAT(*a, moved, (size_t)DARR_ELEM(*a)*(DARR_SIZE(*a)-i-n));
+    }
+    DARR_SIZE(*a) -= n;
+    //reset offset if shrunk to 0
+    if (!DARR_SIZE(*a)) DARR_OFFS(*a) = 0;
+    //release memory if shrunk enough
+    DARR_TRIM(*a);
+}
+DARRDEF void* dynarrRingNew (DARRINT elem, DARRINT c) {
+    //round capacity up to the next power of two
+    DARRINT p = 1;
+    while (p < c) {
+        if (p > DARR_IMAX/2) return NULL;
+        p *= 2;
+    }
+    //create dynarr with that capacity
+    return dynarrNewEx(elem, p, 0, NULL);
+}
+DARRDEF int dynarrRingGrow (void** a) {
+    //grow only if completely full
+    if (DARR_SIZE(*a) < DARR_CAPA(*a)) return 0;
+    //check for capacity overflow
+    DARRINT c = DARR_CAPA(*a);
+    if (c > DARR_IMAX/2) return -1;
+    //double capacity so it stays a power of two
+    if (dynarrRealloc(a, c*2)) return -1;
+    //move wrapped elements from the front to just after the old end
+    DARRINT wrap = DARR_OFFS(*a)+DARR_SIZE(*a)-c;
+    if (wrap > 0) memcpy(&((char*)*a)[(size_t)DARR_ELEM(*a)*c], *a, (size_t)DARR_ELEM(*a)*wrap);
+    //return
+    return 0;
+}
+DARRDEF DARRINT dynarrResize (void** a, DARRINT s) {
     //check if shrinking or growing
     if (s < DARR_SIZE(*a)) {
         //simply shrink size to s
         DARR_SIZE(*a) = (s < 0) ? 0 : s;
         //reset offset if shrunk to 0
         if (!DARR_SIZE(*a)) DARR_OFFS(*a) = 0;
+        //release memory if shrunk enough
+        DARR_TRIM(*a);
     } else if (s > DARR_SIZE(*a)) {
         //make space if new size above capacity
         if (DARR_OFFS(*a)+s > DARR_CAPA(*a)) {
             //reset offset if there is any
             if (DARR_OFFS(*a)) {
-                memmove(*a, DARR_EPTR(*a, 0), DARR_ELEM(*a)*DARR_SIZE(*a));
+                memmove(*a, DARR_EPTR(*a, 0), (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
+                DARR_STAT(*a, compacted, (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
                 DARR_OFFS(*a) = 0;
             }
             //grow if offset reset not enough
-            if (s > DARR_CAPA(*a)) {
+            if (s > DARR_CAPA(*a))
                 //grow to exactly the requested size
-                void* ptr = DYNARR_REALLOC(&DARR_RAW(*a), sizeof(struct dynarr) + DARR_ELEM(*a)*s);
-                //check for realloc failure
-                if (!ptr) return -1;
-                //assign to dynarr pointer
-                *a = &((struct dynarr*)ptr)[1];
-                //update allocated capacity
-                DARR_CAPA(*a) = s;
-            }
+                if (dynarrRealloc(a, s)) return -1;
         }
         //zero out any new elements added
-        memset(DARR_EPTR(*a, DARR_SIZE(*a)), 0, DARR_ELEM(*a)*(s-DARR_SIZE(*a)));
+        memset(DARR_EPTR(*a, DARR_SIZE(*a)), 0, (size_t)DARR_ELEM(*a)*(s-DARR_SIZE(*a)));
         //update to new size
         DARR_SIZE(*a) = s;
     }
     //return
     return DARR_SIZE(*a);
 }
-DARRDEF int dynarrCapacity (void** a, int c) {
+DARRDEF DARRINT dynarrCapacity (void** a, DARRINT c) {
     //clamp to used size
     if (c < DARR_SIZE(*a)) c = DARR_SIZE(*a);
     //reset offset if there is any
     if (DARR_OFFS(*a)) {
-        memmove(*a, DARR_EPTR(*a, 0), DARR_ELEM(*a)*DARR_SIZE(*a));
+        memmove(*a, DARR_EPTR(*a, 0), (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
+        DARR_STAT(*a, compacted, (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
         DARR_OFFS(*a) = 0;
     }
     //adjust capacity if necessary
-    if (c != DARR_CAPA(*a)) {
-        //adjust capacity by reallocation
-        void* ptr = DYNARR_REALLOC(&DARR_RAW(*a), sizeof(struct dynarr) + DARR_ELEM(*a)*c);
-        //check for realloc failure
-        if (!ptr) return -1;
-        //assign to dynarr pointer
-        *a = &((struct dynarr*)ptr)[1];
-        //update allocated capacity
-        DARR_CAPA(*a) = c;
-    }
+    if (c != DARR_CAPA(*a))
+        if (dynarrRealloc(a, c)) return -1;
     //return
     return DARR_CAPA(*a);
 }
-DARRDEF int dynarrFindLinear (const void* a, const void* k) {
-    for (int i = 0; i < DARR_SIZE(a); i++)
-        if (!memcmp(k, DARR_EPTR(a, i), DARR_ELEM(a))) return i;
-    return -1;
+DARRDEF DARRINT dynarrShrink (void** a) {
+    //cheap check for already matching capacity
+    if ((!DARR_OFFS(*a))&&(DARR_SIZE(*a) == DARR_CAPA(*a))) return DARR_CAPA(*a);
+    return dynarrCapacity(a, DARR_SIZE(*a));
 }
-DARRDEF int dynarrFindBinary (const void* a, int(*comp)(const void*, const void*), const void* k) {
-    void* res = bsearch(k, DARR_EPTR(a, 0), DARR_SIZE(a), DARR_ELEM(a), comp);
-    if (!res) return -1; //element not found
-    return ((char*)res - DARR_EPTR(a, 0)) / DARR_ELEM(a);
+DARRDEF DARRINT dynarrTrim (void** a) {
+    //borrowed storage is kept as is, since giving it up gains nothing
+    if (DARR_RAW(*a).flag & DARR_FLAG_BORROW) return DARR_CAPA(*a);
+    //shrink to leave headroom so that capacity doesn't change again soon
+    #ifdef DYNARR_AUTO_SHRINK
+    DARRINT c = DARR_SIZE(*a)*(DYNARR_AUTO_SHRINK)/2;
+    #else
+    DARRINT c = DARR_SIZE(*a)*2;
+    #endif
+    if (c < DYNARR_MIN_CAPACITY) c = DYNARR_MIN_CAPACITY;
+    if (c >= DARR_CAPA(*a)) return DARR_CAPA(*a);
+    //failure to shrink is harmless, old capacity is simply kept
+    DARRINT r = dynarrCapacity(a, c);
+    return (r < 0) ? DARR_CAPA(*a) : r;
 }
-DARRDEF void dynarrSortInsert (void* a, int(*comp)(const void*, const void*)) {
-    for (int j = 1; j < DARR_SIZE(a); j++)
-        for (int i = j; (i > 0)&&(comp(DARR_EPTR(a, i-1), DARR_EPTR(a, i)) > 0); i--) {
-            char temp[DARR_ELEM(a)];
-            memcpy(temp, DARR_EPTR(a, i), DARR_ELEM(a));
-            memcpy(DARR_EPTR(a, i), DARR_EPTR(a, i-1), DARR_ELEM(a));
-            memcpy(DARR_EPTR(a, i-1), temp, DARR_ELEM(a));
+DARRDEF int dynarrSave (const void* a, FILE* f, int flags) {
+    unsigned char head[DARR_WIRE] = {0};
+    uint16_t vers = DARR_WIRE_VERSION, flag = (uint16_t)(flags & DYNARR_WIRE_CHECKSUM);
+    uint32_t elem = (uint32_t)DARR_ELEM(a), alig = (uint32_t)DARR_RAW(a).alig;
+    uint64_t count = (uint64_t)DARR_SIZE(a), sum = 0;
+    size_t size = (size_t)DARR_ELEM(a)*DARR_SIZE(a);
+    if (flag) sum = dynarrChecksum((const unsigned char*)DARR_EPTR(a, 0), size);
+    //fill in header
+    memcpy(head, "DARR", 4);
+    memcpy(head+4, &vers, 2);
+    memcpy(head+6, &flag, 2);
+    memcpy(head+8, &elem, 4);
+    memcpy(head+12, &alig, 4);
+    memcpy(head+16, &count, 8);
+    memcpy(head+24, &sum, 8);
+    //write header, then elements straight from the dynarr
+    if (fwrite(head, 1, DARR_WIRE, f) != DARR_WIRE) return -1;
+    if (fwrite(DARR_EPTR(a, 0), 1, size, f) != size) return -1;
+    return 0;
+}
+DARRDEF void* dynarrLoad (FILE* f, DARRINT elem) {
+    unsigned char head[DARR_WIRE];
+    size_t size = DARR_SMAX, wire;
+    uint64_t sum;
+    int alig;
+    //read the part every version has first, then the rest of the header if it is longer
+    if (fread(head, 1, DARR_WIRE_V1, f) != DARR_WIRE_V1) return NULL;
+    DARRINT count = dynarrWireCheck(head, elem, &size, &alig, &sum, &wire);
+    if (count < 0) return NULL;
+    if (fread(head + DARR_WIRE_V1, 1, wire - DARR_WIRE_V1, f) != wire - DARR_WIRE_V1) return NULL;
+    //allocate exactly the stored size, then read elements straight into it
+    void* a = dynarrNewEx(elem, count, alig, NULL);
+    if (!a) return NULL;
+    if ((fread(DARR_EPTR(a, 0), 1, size, f) != size)||
+        ((sum)&&(dynarrChecksum((const unsigned char*)DARR_EPTR(a, 0), size) != sum))) {
+        dynarrFree(a);
+        return NULL;
+    }
+    DARR_SIZE(a) = count;
+    //return
+    return a;
+}
+DARRDEF void* dynarrView (void* buff, size_t size, DARRINT elem) {
+    uint64_t sum;
+    size_t wire;
+    int alig;
+    if (size < DARR_WIRE_V1) return NULL;
+    DARRINT count = dynarrWireCheck((const unsigned char*)buff, elem, &size, &alig, &sum, &wire);
+    if (count < 0) return NULL;
+    //the dynarr header has to fit behind the fields at the start of the wire header
+    if (DARR_HEAD > wire - 32) return NULL;
+    char* data = (char*)buff + wire;
+    if ((uintptr_t)data % ((alig > 16) ? alig : 16)) return NULL;
+    if ((sum)&&(dynarrChecksum((const unsigned char*)data, size) != sum)) return NULL;
+    //place a borrowed header into the reserved bytes right in front of the elements
+    struct dynarr* darr = (struct dynarr*)(data - DARR_HEAD);
+    memset((void*)darr, 0, sizeof(struct dynarr));
+    darr->capa = darr->size = count;
+    darr->elem = elem;
+    darr->alig = alig;
+    darr->flag = DARR_FLAG_BORROW;
+    //return
+    return data;
+}
+DARRDEF DARRINT dynarrFindLinear (const void* a, const void* k) {
+    return dynarrFindRange(DARR_EPTR(a, 0), DARR_SIZE(a), DARR_ELEM(a), k);
+}
+DARRDEF DARRINT dynarrFindBinary (const void* a, int(*comp)(const void*, const void*), const void* k) {
+    DARRINT i = dynarrLowerBound(a, comp, k);
+    int miss = (i == DARR_SIZE(a))||(DARR_COMP(comp, k, DARR_EPTR(a, i)));
+    DARR_STAT_FLUSH_TOTAL();
+    return miss ? -1 : i; //-1 if element not found
+}
+DARRDEF DARRINT dynarrLowerBound (const void* a, int(*comp)(const void*, const void*), const void* k) {
+    //branch-free search, keeping the result within [b, b+n]
+    DARRINT b = 0, n = DARR_SIZE(a);
+    if (!n) return 0;
+    for (DARRINT h; n > 1; n -= h) {
+        h = n/2;
+        b += (DARR_COMP(comp, k, DARR_EPTR(a, b+h)) > 0) ? h : 0;
+    }
+    b += (DARR_COMP(comp, k, DARR_EPTR(a, b)) > 0);
+    DARR_STAT_FLUSH_TOTAL();
+    //return
+    return b;
+}
+DARRDEF DARRINT dynarrUpperBound (const void* a, int(*comp)(const void*, const void*), const void* k) {
+    //same as lower bound but also skips over equal elements
+    DARRINT b = 0, n = DARR_SIZE(a);
+    if (!n) return 0;
+    for (DARRINT h; n > 1; n -= h) {
+        h = n/2;
+        b += (DARR_COMP(comp, k, DARR_EPTR(a, b+h)) >= 0) ? h : 0;
+    }
+    b += (DARR_COMP(comp, k, DARR_EPTR(a, b)) >= 0);
+    DARR_STAT_FLUSH_TOTAL();
+    //return
+    return b;
+}
+DARRDEF DARRINT dynarrSetOp (void** d, const void* a, const void* b, int(*comp)(const void*, const void*), int op) {
+    DARR_ASSERT((DARR_ELEM(*d) == DARR_ELEM(a))&&(DARR_ELEM(*d) == DARR_ELEM(b))&&(*d != a)&&(*d != b));
+    size_t e = DARR_ELEM(a);
+    DARRINT na = DARR_SIZE(a), nb = DARR_SIZE(b);
+    //reserve once for the largest possible result
+    if ((op <= DARR_SET_UNION)&&(nb > DARR_IMAX-na)) return -1;
+    DARRINT most = (op == DARR_SET_INTERSECT) ? ((na < nb) ? na : nb) : (op == DARR_SET_DIFF) ? na : na+nb;
+    DARR_OFFS(*d) = DARR_SIZE(*d) = 0;
+    if (dynarrReserve(d, most)) return -1;
+    const char* x = DARR_EPTR(a, 0), *xe = x + e*na, *y = DARR_EPTR(b, 0), *ye = y + e*nb;
+    char* o = (char*)*d;
+    if ((op == DARR_SET_INTERSECT)&&(na/16 > nb)) {
+        //find each element of the much smaller third dynarr in the second by exponential search
+        for (; (y < ye)&&(x < xe); y += e) {
+            x += e*dynarrGallop(x, (DARRINT)((size_t)(xe-x)/e), e, comp, y);
+            if ((x < xe)&&(!DARR_COMP(comp, x, y))) { memcpy(o, x, e); o += e; x += e; }
+        }
+    } else if ((op == DARR_SET_INTERSECT)&&(nb/16 > na)) {
+        //same the other way around
+        for (; (x < xe)&&(y < ye); x += e) {
+            y += e*dynarrGallop(y, (DARRINT)((size_t)(ye-y)/e), e, comp, x);
+            if ((y < ye)&&(!DARR_COMP(comp, x, y))) { memcpy(o, x, e); o += e; y += e; }
+        }
+    } else {
+        //linear merge, every operation keeps a different subset of what it steps over
+        while ((x < xe)&&(y < ye)) {
+            int c = DARR_COMP(comp, x, y);
+            if ((c > 0)&&(op <= DARR_SET_UNION)) { memcpy(o, y, e); o += e; }
+            else if ((c < 0)&&(op != DARR_SET_INTERSECT)) { memcpy(o, x, e); o += e; }
+            else if ((!c)&&(op != DARR_SET_DIFF)) { memcpy(o, x, e); o += e; }
+            //merge steps over one equal element at a time, taking the one from the second dynarr first
+            if (c < 0) x += e;
+            else if (c > 0) y += e;
+            else if (op == DARR_SET_MERGE) x += e;
+            else { x += e; y += e; }
         }
+    }
+    //what remains of the second dynarr is kept by all but intersection, of the third by merge and union
+    if (op != DARR_SET_INTERSECT) { memcpy(o, x, xe-x); o += xe-x; }
+    if (op <= DARR_SET_UNION) { memcpy(o, y, ye-y); o += ye-y; }
+    DARR_SIZE(*d) = (DARRINT)((size_t)(o - (char*)*d)/e);
+    DARR_STAT_FLUSH(*d);
+    //release memory if the result is much smaller than reserved
+    DARR_TRIM(*d);
+    return DARR_SIZE(*d);
+}
+DARRDEF DARRINT dynarrUnique (void** a, int(*comp)(const void*, const void*)) {
+    size_t e = DARR_ELEM(*a);
+    char* p = DARR_EPTR(*a, 0), *w = p, *end = p + e*DARR_SIZE(*a);
+    //compact to the front, each element is compared to the last one kept
+    if (p < end) for (char* r = p+e; r < end; r += e) {
+        if (comp ? !DARR_COMP(comp, w, r) : !memcmp(w, r, e)) continue;
+        w += e;
+        if (w != r) memcpy(w, r, e);
+    }
+    DARR_SIZE(*a) = (p < end) ? (DARRINT)((size_t)(w-p)/e) + 1 : 0;
+    DARR_STAT_FLUSH(*a);
+    if (!DARR_SIZE(*a)) DARR_OFFS(*a) = 0;
+    //release memory if shrunk enough
+    DARR_TRIM(*a);
+    return DARR_SIZE(*a);
+}
+DARRDEF DARRINT dynarrSortLast (void* a, int(*comp)(const void*, const void*)) {
+    DARRINT i = dynarrSortPlace(a, DARR_SIZE(a)-1, comp);
+    DARR_STAT_FLUSH(a);
+    return i;
+}
+DARRDEF void dynarrSortInsert (void* a, int(*comp)(const void*, const void*)) {
+    for (DARRINT j = 1; j < DARR_SIZE(a); j++)
+        //only search and move if out of order
+        if (DARR_COMP(comp, DARR_EPTR(a, j-1), DARR_EPTR(a, j)) > 0) dynarrSortPlace(a, j, comp);
+    DARR_STAT_FLUSH(a);
 }
 DARRDEF void dynarrSortStandard (void* a, int(*comp)(const void*, const void*)) {
-    qsort(DARR_EPTR(a, 0), DARR_SIZE(a), DARR_ELEM(a), comp);
+    //depth limit of 2*log2(n) before falling back to heapsort
+    int depth = 0;
+    for (DARRINT n = DARR_SIZE(a); n > 1; n /= 2) depth += 2;
+    dynarrSortIntro(DARR_EPTR(a, 0), DARR_SIZE(a), DARR_ELEM(a), comp, depth);
+    DARR_STAT_FLUSH(a);
+}
+DARRDEF int dynarrSortRadix (void* a, int kind) {
+    DARR_ASSERT((DARR_ELEM(a) == 1)||(DARR_ELEM(a) == 2)||(DARR_ELEM(a) == 4)||(DARR_ELEM(a) == 8));
+    DARR_ASSERT((kind != DYNARR_RADIX_FLOAT)||(DARR_ELEM(a) == 4)||(DARR_ELEM(a) == 8));
+    size_t n = DARR_SIZE(a), elem = DARR_ELEM(a);
+    if (n < 2) return 0;
+    //allocate temporary buffer to scatter into
+    void* temp = DYNARR_REALLOC(NULL, elem*n);
+    if (!temp) return -1;
+    //dispatch to radix sort of matching width
+    switch (elem) {
+        case 1: dynarrRadix8((uint8_t*)DARR_EPTR(a, 0), (uint8_t*)temp, n, kind); break;
+        case 2: dynarrRadix16((uint16_t*)DARR_EPTR(a, 0), (uint16_t*)temp, n, kind); break;
+        case 4: dynarrRadix32((uint32_t*)DARR_EPTR(a, 0), (uint32_t*)temp, n, kind); break;
+        case 8: dynarrRadix64((uint64_t*)DARR_EPTR(a, 0), (uint64_t*)temp, n, kind); break;
+    }
+    //free temporary buffer and return
+    DYNARR_FFREE(temp);
+    return 0;
+}
+DARRDEF void dynarrSortParallel (void* a, int(*comp)(const void*, const void*), struct dynarrexec* exec) {
+    //one chunk per thread, but never so small that splitting isn't worth it
+    size_t n = DARR_SIZE(a), t = (size_t)dynarrExecWidth(exec);
+    size_t k = (n/DARR_PAR_MIN < t) ? n/DARR_PAR_MIN : t;
+    char* temp = (k > 1) ? (char*)DYNARR_REALLOC(NULL, n*DARR_ELEM(a)) : NULL;
+    if (!temp) {
+        dynarrSortStandard(a, comp);
+        return;
+    }
+    size_t bnds[DYNARR_MAX_THREADS+1];
+    for (size_t i = 0; i <= k; i++) bnds[i] = n*i/k;
+    struct dynarrsortpar s = {DARR_EPTR(a, 0), temp, (size_t)DARR_ELEM(a), comp, bnds, k, 1, 1, NULL};
+    #ifdef DYNARR_STATS
+    //comparator calls of each task, there are never more than k+t tasks at once
+    uint64_t comps[2*DYNARR_MAX_THREADS];
+    s.comps = comps;
+    #endif
+    //sort chunks in place
+    dynarrExecRun(exec, dynarrSortChunk, &s, (DARRINT)k);
+    DARR_STAT_GATHER(&s, k);
+    //merge pairs of runs back and forth, splitting each merge so there are always about t tasks
+    for (;;) {
+        size_t pairs = (k + 2*s.width-1)/(2*s.width);
+        //a single run left in the temporary buffer is copied back as a merge with an empty run
+        if ((s.width >= k)&&(s.src == DARR_EPTR(a, 0))) break;
+        s.parts = (t + pairs-1)/pairs;
+        dynarrExecRun(exec, dynarrSortMerge, &s, (DARRINT)(pairs*s.parts));
+        DARR_STAT_GATHER(&s, pairs*s.parts);
+        char* x = s.src; s.src = s.dst; s.dst = x;
+        if (s.width >= k) break;
+        s.width *= 2;
+    }
+    DARR_STAT_FLUSH(a);
+    //free temporary buffer
+    DYNARR_FFREE(temp);
+}
+DARRDEF DARRINT dynarrFindParallel (const void* a, const void* k, struct dynarrexec* exec) {
+    int t = dynarrExecWidth(exec);
+    if ((t < 2)||(DARR_SIZE(a) < 2*DARR_PAR_MIN)) return dynarrFindLinear(a, k);
+    DARRINT hits[DYNARR_MAX_THREADS];
+    struct dynarrfindpar f = {DARR_EPTR(a, 0), k, DARR_ELEM(a), 0, DARR_PAR_MIN, DARR_SIZE(a), hits};
+    //scan rounds of t chunks, doubling chunk size each round
+    for (;;) {
+        dynarrExecRun(exec, dynarrFindChunk, &f, t);
+        for (int i = 0; i < t; i++) if (hits[i] >= 0) return hits[i];
+        if (f.end - f.base <= (DARRINT)t*f.part) return -1;
+        f.base += (DARRINT)t*f.part;
+        if (f.part <= (DARR_IMAX/2)/t) f.part *= 2;
+    }
+}
+DARRDEF void dynarrMap (void* a, void (*map)(void*, void*), void* ctx, struct dynarrexec* exec) {
+    struct dynarrbulk b;
+    dynarrBulkInit(&b, a, exec, ctx);
+    b.map = map;
+    dynarrExecRun(exec, dynarrMapChunk, &b, b.parts);
+}
+DARRDEF void dynarrReduce (const void* a, void (*fold)(void*, const void*, void*), void (*join)(void*, const void*, void*),
+    void* acc, size_t accsize, void* ctx, struct dynarrexec* exec) {
+    struct dynarrbulk b;
+    dynarrBulkInit(&b, a, exec, ctx);
+    b.fold = fold;
+    //partial accumulators are aligned to the largest power of two dividing their size, which covers their type
+    size_t alig = accsize & (~accsize + 1);
+    char* temp = ((b.parts > 1)&&(join)) ? (char*)DYNARR_REALLOC(NULL, accsize*b.parts + alig-1) : NULL;
+    //a single chunk folds straight into the accumulator, which is all that can be done without a join
+    if (!temp) {
+        b.parts = 1;
+        b.accs = acc;
+        dynarrReduceChunk(&b, 0);
+        return;
+    }
+    //otherwise each chunk starts from a copy of the identity, and partials are joined in order
+    char* accs = temp + (alig - (uintptr_t)temp%alig)%alig;
+    for (DARRINT i = 0; i < b.parts; i++) memcpy(accs + accsize*i, acc, accsize);
+    b.accs = accs;
+    b.accsize = accsize;
+    dynarrExecRun(exec, dynarrReduceChunk, &b, b.parts);
+    memcpy(acc, accs, accsize);
+    for (DARRINT i = 1; i < b.parts; i++) join(acc, accs + accsize*i, ctx);
+    //free temporary buffer
+    DYNARR_FFREE(temp);
+}
+DARRDEF DARRINT dynarrFilter (void** a, int (*keep)(const void*, void*), void* ctx, struct dynarrexec* exec) {
+    struct dynarrbulk b;
+    dynarrBulkInit(&b, *a, exec, ctx);
+    DARRINT kept[DYNARR_MAX_THREADS];
+    b.keep = keep;
+    b.kept = kept;
+    dynarrExecRun(exec, dynarrFilterChunk, &b, b.parts);
+    //move the compacted chunks together
+    DARRINT size = 0;
+    for (DARRINT i = 0; i < b.parts; i++) {
+        if (i) memmove(b.p + b.elem*size, DARR_CHUNK(&b, i), b.elem*kept[i]);
+        size += kept[i];
+    }
+    DARR_SIZE(*a) = size;
+    if (!size) DARR_OFFS(*a) = 0;
+    //release memory if shrunk enough
+    DARR_TRIM(*a);
+    return size;
+}
+#ifdef DYNARR_STATS
+DARRDEF void* dynarrStatsTag (void* a, const char* tag) {
+    if (a) DARR_RAW(a).stat.tag = tag;
+    return a;
+}
+DARRDEF const struct dynarrstats* dynarrStatsTotal (void) {
+    #ifdef DYNARR_ATOMIC
+    //copy the process-wide totals into this thread's snapshot
+    dynarrStatsCopy.reallocs = atomic_load_explicit(&dynarrStatsSum.reallocs, memory_order_relaxed);
+    dynarrStatsCopy.compacted = atomic_load_explicit(&dynarrStatsSum.compacted, memory_order_relaxed);
+    dynarrStatsCopy.moved = atomic_load_explicit(&dynarrStatsSum.moved, memory_order_relaxed);
+    dynarrStatsCopy.compares = atomic_load_explicit(&dynarrStatsSum.compares, memory_order_relaxed);
+    dynarrStatsCopy.peak = atomic_load_explicit(&dynarrStatsSum.peak, memory_order_relaxed);
+    return &dynarrStatsCopy;
+    #else
+    return &dynarrStatsSum;
+    #endif
+}
+DARRDEF void dynarrStatsHook (void (*hook)(const void*, size_t, size_t, const char*)) {
+    dynarrStatsHookFunc = hook;
+}
+#endif
+#ifdef DYNARR_THREADS
+DARRDEF void dynarrExecThreads (struct dynarrexec* exec, int threads) {
+    #ifdef _SC_NPROCESSORS_ONLN
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+    exec->run = dynarrThreadsRun;
+    exec->threads = (threads > 0) ? threads : 1;
+}
+#endif
+#ifdef DYNARR_ATOMIC
+DARRDEF void* dynarrQueueNew (DARRINT elem, DARRINT c, int mpmc) {
+    //round capacity up to the next power of two, mpmc queues need at least two slots
+    size_t p = mpmc ? 2 : 1;
+    while ((DARRINT)p < c) {
+        if (p > (size_t)DARR_IMAX/2) return NULL;
+        p *= 2;
+    }
+    //element bytes rounded up so sequence numbers behind them are aligned
+    size_t data = (size_t)elem*p, line = DYNARR_CACHE_LINE;
+    if (p > (DARR_SMAX - sizeof(struct dynarrqueue) - 2*line)/(elem + sizeof(atomic_size_t))) return NULL;
+    data = (data + sizeof(atomic_size_t)-1)/sizeof(atomic_size_t)*sizeof(atomic_size_t);
+    //allocate queue with space for elements, sequence numbers, and alignment slack
+    char* base = (char*)DYNARR_ZALLOC(line-1 + sizeof(struct dynarrqueue) + data + (mpmc ? p*sizeof(atomic_size_t) : 0));
+    if (!base) return NULL;
+    //place header on a cache line boundary
+    struct dynarrqueue* q = (struct dynarrqueue*)(base + (line - (uintptr_t)base%line)%line);
+    //fill in values
+    q->mask = p-1;
+    q->elem = elem;
+    q->base = base;
+    q->seqs = NULL;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    if (mpmc) {
+        //each slot starts out free for the push at its own position
+        q->seqs = (atomic_size_t*)((char*)&q[1] + data);
+        for (size_t i = 0; i < p; i++) atomic_init(&q->seqs[i], i);
+    }
+    //return
+    return &q[1];
 }
+DARRDEF const void* dynarrSnapshot (const void* a) {
+    //only holders take snapshots, so the count can't drop to zero meanwhile and relaxed is enough
+    atomic_fetch_add_explicit(&DARR_RAW(a).refs, 1, memory_order_relaxed);
+    return a;
+}
+DARRDEF int dynarrUnshare (void** a) {
+    //nothing to do without live snapshots, acquire so that their reads are done before any writes
+    if (!atomic_load_explicit(&DARR_RAW(*a).refs, memory_order_acquire)) return 0;
+    //copy elements to new storage of the same capacity, which only the writer holds
+    void* n = dynarrNewEx(DARR_ELEM(*a), DARR_CAPA(*a), DARR_RAW(*a).alig, DARR_RAW(*a).allo);
+    if (!n) return -1;
+    memcpy(n, DARR_EPTR(*a, 0), (size_t)DARR_ELEM(*a)*DARR_SIZE(*a));
+    DARR_SIZE(n) = DARR_SIZE(*a);
+    #ifdef DYNARR_STATS
+    DARR_RAW(n).stat = DARR_RAW(*a).stat;
+    #endif
+    //let go of the old storage, which the last snapshot released then frees
+    dynarrFree(*a);
+    *a = n;
+    //return
+    return 0;
+}
+DARRDEF void dynarrQueueFree (void* q) {
+    DYNARR_FFREE(DARR_QUEUE(q).base);
+}
+DARRDEF DARRINT dynarrQueueSize (const void* q) {
+    size_t h = atomic_load_explicit(&DARR_QUEUE(q).head, memory_order_acquire);
+    size_t t = atomic_load_explicit(&DARR_QUEUE(q).tail, memory_order_acquire);
+    //head may have been loaded before a concurrent push and pop
+    return (t > h) ? (DARRINT)(t-h) : 0;
+}
+DARRDEF int dynarrSpscPush (void* q, const void* p) {
+    struct dynarrqueue* dq = &DARR_QUEUE(q);
+    size_t t = atomic_load_explicit(&dq->tail, memory_order_relaxed);
+    //check against cached head first, only reload it if the queue seems full
+    if (t - dq->head_cache > dq->mask) {
+        dq->head_cache = atomic_load_explicit(&dq->head, memory_order_acquire);
+        if (t - dq->head_cache > dq->mask) return -1;
+    }
+    //copy element in, then publish it to the consumer
+    memcpy((char*)q + (t & dq->mask)*dq->elem, p, dq->elem);
+    atomic_store_explicit(&dq->tail, t+1, memory_order_release);
+    return 0;
+}
+DARRDEF int dynarrSpscDequeue (void* q, void* p) {
+    struct dynarrqueue* dq = &DARR_QUEUE(q);
+    size_t h = atomic_load_explicit(&dq->head, memory_order_relaxed);
+    //check against cached tail first, only reload it if the queue seems empty
+    if (h == dq->tail_cache) {
+        dq->tail_cache = atomic_load_explicit(&dq->tail, memory_order_acquire);
+        if (h == dq->tail_cache) return -1;
+    }
+    //copy element out, then hand the slot back to the producer
+    memcpy(p, (char*)q + (h & dq->mask)*dq->elem, dq->elem);
+    atomic_store_explicit(&dq->head, h+1, memory_order_release);
+    return 0;
+}
+DARRDEF int dynarrMpmcPush (void* q, const void* p) {
+    struct dynarrqueue* dq = &DARR_QUEUE(q);
+    size_t t = atomic_load_explicit(&dq->tail, memory_order_relaxed);
+    for (;;) {
+        //slot is free for this position once its sequence number matches
+        size_t seq = atomic_load_explicit(&dq->seqs[t & dq->mask], memory_order_acquire);
+        ptrdiff_t diff = (ptrdiff_t)(seq - t);
+        if (!diff) {
+            //try to claim the position, on failure t is updated to the current tail
+            if (atomic_compare_exchange_weak_explicit(&dq->tail, &t, t+1, memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            //slot still holds an element from one lap ago, queue is full
+            return -1;
+        } else {
+            //another producer got there first
+            t = atomic_load_explicit(&dq->tail, memory_order_relaxed);
+        }
+    }
+    //copy element in, then mark the slot as ready for the consumer at this position
+    memcpy((char*)q + (t & dq->mask)*dq->elem, p, dq->elem);
+    atomic_store_explicit(&dq->seqs[t & dq->mask], t+1, memory_order_release);
+    return 0;
+}
+DARRDEF int dynarrMpmcDequeue (void* q, void* p) {
+    struct dynarrqueue* dq = &DARR_QUEUE(q);
+    size_t h = atomic_load_explicit(&dq->head, memory_order_relaxed);
+    for (;;) {
+        //slot is ready for this position once its sequence number is one past it
+        size_t seq = atomic_load_explicit(&dq->seqs[h & dq->mask], memory_order_acquire);
+        ptrdiff_t diff = (ptrdiff_t)(seq - (h+1));
+        if (!diff) {
+            //try to claim the position, on failure h is updated to the current head
+            if (atomic_compare_exchange_weak_explicit(&dq->head, &h, h+1, memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            //slot has not been filled yet, queue is empty
+            return -1;
+        } else {
+            //another consumer got there first
+            h = atomic_load_explicit(&dq->head, memory_order_relaxed);
+        }
+    }
+    //copy element out, then free the slot for the push one lap ahead
+    memcpy(p, (char*)q + (h & dq->mask)*dq->elem, dq->elem);
+    atomic_store_explicit(&dq->seqs[h & dq->mask], h + dq->mask+1, memory_order_release);
+    return 0;
+}
+#endif
+#ifdef DYNARR_MMAP
+DARRDEF void* dynarrMapOpen (struct dynarrmap* map, const char* path, DARRINT elem) {
+    struct stat st;
+    map->base.func = dynarrMapFunc;
+    map->size = 0;
+    map->fd = open(path, O_RDWR|O_CREAT, 0644);
+    if (map->fd < 0) return NULL;
+    if (fstat(map->fd, &st)) {
+        close(map->fd);
+        return NULL;
+    }
+    //empty files get a fresh dynarr, which is created directly in the mapping
+    if (!st.st_size) {
+        void* a = dynarrNewEx(elem, DYNARR_MIN_CAPACITY, 0, &map->base);
+        if (!a) close(map->fd);
+        return a;
+    }
+    //anything else must at least hold a header
+    if ((size_t)st.st_size < DARR_HEAD) {
+        close(map->fd);
+        return NULL;
+    }
+    char* ptr = (char*)mmap(NULL, (size_t)st.st_size, PROT_READ|PROT_WRITE, MAP_SHARED, map->fd, 0);
+    if (ptr == MAP_FAILED) {
+        close(map->fd);
+        return NULL;
+    }
+    map->size = (size_t)st.st_size;
+    //validate stored header against the file it came from
+    struct dynarr* darr = (struct dynarr*)ptr;
+    DARRINT c = (DARRINT)(((size_t)st.st_size - DARR_HEAD)/elem);
+    if ((darr->elem != elem)||(darr->offs < 0)||(darr->size < 0)||(darr->offs > c - darr->size)) {
+        munmap(ptr, map->size);
+        close(map->fd);
+        return NULL;
+    }
+    //fix up fields that only make sense within this process
+    darr->capa = c;
+    darr->alig = darr->padd = darr->flag = 0;
+    darr->allo = &map->base;
+    #ifdef DYNARR_ATOMIC
+    atomic_init(&darr->refs, 0);
+    #endif
+    #ifdef DYNARR_STATS
+    memset(&darr->stat, 0, sizeof(struct dynarrstats));
+    #endif
+    //return
+    return ptr + DARR_HEAD;
+}
+DARRDEF int dynarrMapSync (void* a) {
+    struct dynarrmap* map = (struct dynarrmap*)DARR_RAW(a).allo;
+    return msync(DARR_BASE(a), map->size, MS_SYNC) ? -1 : 0;
+}
+DARRDEF void dynarrHugeInit (struct dynarrhuge* huge, size_t thresh, int flags, unsigned long nodes) {
+    huge->base.func = dynarrHugeFunc;
+    huge->thresh = thresh ? thresh : 1;
+    huge->nodes = nodes;
+    huge->flags = flags;
+    #ifndef MAP_ANONYMOUS
+    //no anonymous mappings, so everything goes through DYNARR_REALLOC
+    huge->thresh = DARR_SMAX;
+    #endif
+}
+#endif
 
 #endif //DYNARR_IMPLEMENTATION
\ No newline at end of file
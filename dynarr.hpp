@@ -0,0 +1,389 @@
+/*
+dynarr.hpp - Type-safe C++ wrapper around dynarr.h for elements of any type, trivial or not
+
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring
+rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software.
+If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+/*
+dynarr.hpp usage:
+    Requires C++11. Include it instead of or after dynarr.h with the same configuration that dynarr.h is used with, i.e.
+    define DYNARR_STATIC or DYNARR_IMPLEMENTATION before it where needed. The resulting dynarray<T> is a container on
+    top of a regular dynarr, so it shares its header layout, growth policy, allocators, and front offset.
+    Instead of returning error codes, allocation failures throw std::bad_alloc and size overflows std::length_error.
+
+dynarr.hpp relocation:
+    The dynarr functions move elements around bytewise using realloc and memmove, which is only correct for types that
+    can be relocated that way. dynarray<T> uses them whenever dynarrrelocatable<T> is true, which by default it is for
+    trivially copyable types. Other types are grown by move constructing their elements into new storage, falling back
+    to copying if the move constructor isn't noexcept, so that a throwing element leaves the dynarray unchanged.
+    Types that own resources but don't depend on their own address (e.g. std::unique_ptr) can opt into the fast path:
+        template <> struct dynarrrelocatable<T> : std::true_type {};
+
+dynarr.hpp reference:
+dynarray<T>(), dynarray<T>(struct dynarralloc*)
+    creates an empty dynarray, optionally with all memory managed by the given allocator, allocates nothing until used
+dynarray<T>(int), dynarray<T>(std::initializer_list<T>)
+    creates a dynarray with the given number of value initialized elements or the given elements
+dynarray<T>(const dynarray<T>&), dynarray<T>(dynarray<T>&&)
+    copy constructs every element using the same allocator, or takes over the storage of the other which is left empty
+int size(), int capacity(), bool empty()
+    returns the number of elements, the number of elements that fit before the next growth, and whether size is 0, O(1)
+T* data(), T* begin(), T* end()
+    returns a pointer to the first element and one past the last element, invalidated by anything that adds elements
+T& operator[](int), T& at(int), T& front(), T& back()
+    returns a reference to the element at the given index, at throws std::out_of_range instead of asserting
+void reserve(int), void shrink_to_fit()
+    grows capacity according to the growth policy until the given number of elements fit, or shrinks it to size
+void clear(), void resize(int)
+    destroys all elements without releasing memory, or value initializes or destroys elements at the end to reach given size
+void push_back(const T&), void push_back(T&&), T& emplace_back(args...)
+    adds an element at the end, emplace constructs it in place from the given arguments without making a temporary
+    arguments may refer to elements of the dynarray itself, amortized O(1)
+void pop_back(), void pop_front()
+    destroys the last or first element, both O(1) as removing the first element only advances the offset
+T* insert(const T*, const T&), T* insert(const T*, T&&), T* emplace(const T*, args...)
+    inserts an element before the given position and returns a pointer to it, moving the closer end out of the way, O(n)
+T* erase(const T*), T* erase(const T*, const T*)
+    destroys the element or range at the given position and returns a pointer to the element after it, O(n)
+void swap(dynarray<T>&)
+    exchanges the contents of two dynarrays, O(1)
+T*& raw()
+    returns the underlying dynarr for use with the DYNARR_XXX macros, allocating it first if needed
+    macros that add, remove, or reorder elements must only be used on it if dynarrrelocatable<T> is true
+*/
+
+//header section
+#ifndef DYNARR_HPP
+#define DYNARR_HPP
+
+//includes
+#include "dynarr.h" //dynarr
+#include <cstddef> //max_align_t
+#include <new> //placement new
+#include <utility> //std::move
+#include <type_traits> //std::is_trivially_copyable
+#include <initializer_list> //std::initializer_list
+#include <stdexcept> //std::out_of_range
+
+//same defaults as the implementation section, which may not be part of this compilation unit
+#ifndef DYNARR_GROWTH
+    #define DYNARR_GROWTH 2
+#endif
+#ifndef DYNARR_MIN_CAPACITY
+    #define DYNARR_MIN_CAPACITY 1
+#endif
+#ifndef DYNARR_MAX_GROWTH
+    #define DYNARR_MAX_GROWTH 0
+#endif
+
+//relocation trait
+template <class T> struct dynarrrelocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+//container
+template <class T> class dynarray {
+public:
+    typedef T value_type;
+    typedef DARRINT size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    //constructors and destructor
+    dynarray () noexcept : p(NULL), allo(NULL) {}
+    explicit dynarray (struct dynarralloc* l) noexcept : p(NULL), allo(l) {}
+    explicit dynarray (DARRINT n) : p(NULL), allo(NULL) {
+        resize(n);
+    }
+    dynarray (std::initializer_list<T> l) : p(NULL), allo(NULL) {
+        copy(l.begin(), (DARRINT)l.size());
+    }
+    dynarray (const dynarray& o) : p(NULL), allo(o.allo) {
+        copy(o.begin(), o.size());
+    }
+    dynarray (dynarray&& o) noexcept : p(o.p), allo(o.allo) {
+        o.p = NULL;
+    }
+    ~dynarray () {
+        if (!p) return;
+        destroy(begin(), end());
+        dynarrFree(p);
+    }
+    dynarray& operator= (const dynarray& o) {
+        if (this != &o) dynarray(o).swap(*this);
+        return *this;
+    }
+    dynarray& operator= (dynarray&& o) noexcept {
+        dynarray(std::move(o)).swap(*this);
+        return *this;
+    }
+    //size and capacity
+    DARRINT size () const noexcept {return p ? DARR_SIZE(p) : 0;}
+    DARRINT capacity () const noexcept {return p ? DARR_CAPA(p)-DARR_OFFS(p) : 0;}
+    bool empty () const noexcept {return !size();}
+    //element access
+    T* data () noexcept {return p ? p + DARR_OFFS(p) : NULL;}
+    const T* data () const noexcept {return p ? p + DARR_OFFS(p) : NULL;}
+    T* begin () noexcept {return data();}
+    const T* begin () const noexcept {return data();}
+    T* end () noexcept {return data() + size();}
+    const T* end () const noexcept {return data() + size();}
+    T& operator[] (DARRINT i) {return DYNARR_AT(p, i);}
+    const T& operator[] (DARRINT i) const {return DYNARR_AT(p, i);}
+    T& at (DARRINT i) {
+        if ((i < 0)||(i >= size())) throw std::out_of_range("dynarray::at");
+        return data()[i];
+    }
+    const T& at (DARRINT i) const {
+        if ((i < 0)||(i >= size())) throw std::out_of_range("dynarray::at");
+        return data()[i];
+    }
+    T& front () {return DYNARR_FIRST(p);}
+    const T& front () const {return DYNARR_FIRST(p);}
+    T& back () {return DYNARR_LAST(p);}
+    const T& back () const {return DYNARR_LAST(p);}
+    T*& raw () {
+        if (!p) make(DYNARR_MIN_CAPACITY);
+        return p;
+    }
+    //capacity management
+    void reserve (DARRINT n) {
+        if (n > size()) room(n - size());
+    }
+    void shrink_to_fit () {
+        if ((!p)||((!DARR_OFFS(p))&&(DARR_SIZE(p) == DARR_CAPA(p)))) return;
+        //failure to shrink in place is harmless, old capacity is simply kept
+        if (dynarrrelocatable<T>::value) dynarrShrink((void**)&p);
+        else relocate(DARR_SIZE(p));
+    }
+    void clear () noexcept {
+        if (!p) return;
+        destroy(begin(), end());
+        DARR_SIZE(p) = DARR_OFFS(p) = 0;
+    }
+    void resize (DARRINT n) {
+        DARRINT s = size();
+        if (n < s) {
+            erase(begin()+n, end());
+        } else if (n > s) {
+            //count each new element as soon as it exists, so that a throwing constructor leaves no gap
+            T* e = room(n - s);
+            for (; s < n; s++, e++) {
+                ::new((void*)e) T();
+                DARR_SIZE(p)++;
+            }
+        }
+    }
+    //adding and removing elements
+    void push_back (const T& v) {emplace_back(v);}
+    void push_back (T&& v) {emplace_back(std::move(v));}
+    template <class... A> T& emplace_back (A&&... args) {
+        //construct in place if there is space at the end, which is the common case
+        if ((p)&&(DARR_OFFS(p)+DARR_SIZE(p) < DARR_CAPA(p))) {
+            T* e = p + DARR_OFFS(p) + DARR_SIZE(p);
+            ::new((void*)e) T(std::forward<A>(args)...);
+            DARR_SIZE(p)++;
+            return *e;
+        }
+        return grow(std::forward<A>(args)...);
+    }
+    void pop_back () {
+        DARR_ASSERT(size());
+        (p + DARR_OFFS(p) + --DARR_SIZE(p))->~T();
+        if (!DARR_SIZE(p)) DARR_OFFS(p) = 0;
+    }
+    void pop_front () {
+        DARR_ASSERT(size());
+        (p + DARR_OFFS(p)++)->~T();
+        if (!--DARR_SIZE(p)) DARR_OFFS(p) = 0;
+    }
+    T* insert (const T* pos, const T& v) {return emplace(pos, v);}
+    T* insert (const T* pos, T&& v) {return emplace(pos, std::move(v));}
+    template <class... A> T* emplace (const T* pos, A&&... args) {
+        DARRINT i = pos - begin();
+        DARR_ASSERT((i >= 0)&&(i <= size()));
+        if (i == size()) return &emplace_back(std::forward<A>(args)...);
+        if (dynarrrelocatable<T>::value) {
+            //construct element first as it may refer to one that is about to move, then insert it bytewise
+            alignas(T) unsigned char t[sizeof(T)];
+            ::new((void*)t) T(std::forward<A>(args)...);
+            if (dynarrInsertN((void**)&p, i, t, 1) < 0) {
+                reinterpret_cast<T*>(t)->~T();
+                throw std::bad_alloc();
+            }
+        } else {
+            //otherwise make space at the end and shift elements after the position back by move assignment
+            T t(std::forward<A>(args)...);
+            T* e = room(1);
+            ::new((void*)e) T(std::move(e[-1]));
+            DARR_SIZE(p)++;
+            for (e--; e != begin()+i; e--) *e = std::move(e[-1]);
+            *e = std::move(t);
+        }
+        return begin()+i;
+    }
+    T* erase (const T* pos) {return erase(pos, pos+1);}
+    T* erase (const T* first, const T* last) {
+        DARRINT i = first - begin(), n = last - first;
+        DARR_ASSERT((i >= 0)&&(n >= 0)&&(n <= size()-i));
+        if (!n) return begin()+i;
+        if (dynarrrelocatable<T>::value) {
+            //destroy range and let dynarr close the gap from whichever side is shorter
+            destroy(begin()+i, begin()+i+n);
+            dynarrRemoveRange((void**)&p, i, n);
+        } else {
+            //otherwise shift elements after the range forward by move assignment and destroy the leftovers
+            T* d = begin()+i;
+            for (T* s = d+n; s != end(); s++, d++) *d = std::move(*s);
+            destroy(d, end());
+            DARR_SIZE(p) -= n;
+            if (!DARR_SIZE(p)) DARR_OFFS(p) = 0;
+        }
+        return begin()+i;
+    }
+    void swap (dynarray& o) noexcept {
+        T* t = p; p = o.p; o.p = t;
+        struct dynarralloc* l = allo; allo = o.allo; o.allo = l;
+    }
+private:
+    //dynarr pointer, NULL while nothing is allocated, and allocator to use once something is
+    T* p;
+    struct dynarralloc* allo;
+    //alignment passed to dynarr, 0 unless the type needs more than the allocator gives
+    static int alignment () {return (alignof(T) > alignof(std::max_align_t)) ? (int)alignof(T) : 0;}
+    static DARRINT growth (DARRINT capa, DARRINT n) {
+        //same policy as dynarrGrowth in the implementation section
+        double g = (double)capa*(DYNARR_GROWTH);
+        DARRINT c = (g >= (double)DARR_IMAX) ? DARR_IMAX : (DARRINT)g;
+        if ((DYNARR_MAX_GROWTH > 0)&&((size_t)(c - capa) > (size_t)(DYNARR_MAX_GROWTH)/sizeof(T)))
+            c = capa + (DARRINT)((size_t)(DYNARR_MAX_GROWTH)/sizeof(T));
+        if (c < DYNARR_MIN_CAPACITY) c = DYNARR_MIN_CAPACITY;
+        if (c < n) c = n;
+        return c;
+    }
+    static void destroy (T* first, T* last) noexcept {
+        if (!std::is_trivially_destructible<T>::value)
+            for (; first != last; first++) first->~T();
+    }
+    static T* allocate (DARRINT c, struct dynarralloc* allo) {
+        T* q = (T*)DARR_TAG(dynarrNewEx(sizeof(T), c, alignment(), allo));
+        if (!q) throw std::bad_alloc();
+        return q;
+    }
+    void make (DARRINT c) {
+        p = allocate(c, allo);
+    }
+    void copy (const T* src, DARRINT n) {
+        if (!n) return;
+        make(n);
+        //count each element as soon as it exists, so that the destructor cleans up after a throwing copy
+        try {
+            for (T* e = p; n; n--, e++, src++) {
+                ::new((void*)e) T(*src);
+                DARR_SIZE(p)++;
+            }
+        } catch (...) {
+            destroy(begin(), end());
+            dynarrFree(p);
+            throw;
+        }
+    }
+    T* room (DARRINT n) {
+        //make sure n more elements fit at the end and return where the first of them goes
+        if (!p) {
+            make(growth(0, n));
+        } else if (n > DARR_CAPA(p)-DARR_OFFS(p)-DARR_SIZE(p)) {
+            if (n > DARR_IMAX-DARR_SIZE(p)) throw std::length_error("dynarray");
+            if (dynarrrelocatable<T>::value) {
+                if (dynarrReserve((void**)&p, n)) throw std::bad_alloc();
+            } else {
+                relocate(growth(DARR_CAPA(p), DARR_SIZE(p)+n));
+            }
+        }
+        return p + DARR_OFFS(p) + DARR_SIZE(p);
+    }
+    void relocate (DARRINT c) {
+        //move elements into new storage, only freeing the old one once all of them made it
+        T* q = allocate(c, DARR_RAW(p).allo);
+        try {
+            transfer(q);
+        } catch (...) {
+            dynarrFree(q);
+            throw;
+        }
+        dynarrFree(p);
+        p = q;
+    }
+    void transfer (T* q) {
+        //construct elements in new storage from the old ones, destroying what was constructed if one throws
+        DARRINT s = DARR_SIZE(p), i = 0;
+        T* e = begin();
+        try {
+            for (; i < s; i++) ::new((void*)(q+i)) T(std::move_if_noexcept(e[i]));
+        } catch (...) {
+            destroy(q, q+i);
+            throw;
+        }
+        destroy(e, e+s);
+        DARR_SIZE(q) = s;
+    }
+    template <class... A> T& grow (A&&... args) {
+        if (!p) {
+            //nothing is allocated yet, so the arguments can't refer to it and the element goes straight in
+            make(growth(0, 1));
+            ::new((void*)p) T(std::forward<A>(args)...);
+            DARR_SIZE(p)++;
+            return *p;
+        }
+        if (DARR_SIZE(p) == DARR_IMAX) throw std::length_error("dynarray");
+        if (dynarrrelocatable<T>::value) {
+            //construct element first as its arguments may refer to the storage that is about to move
+            alignas(T) unsigned char t[sizeof(T)];
+            ::new((void*)t) T(std::forward<A>(args)...);
+            if (dynarrGrow((void**)&p)) {
+                reinterpret_cast<T*>(t)->~T();
+                throw std::bad_alloc();
+            }
+            T* e = p + DARR_OFFS(p) + DARR_SIZE(p);
+            memcpy((void*)e, t, sizeof(T));
+            DARR_SIZE(p)++;
+            return *e;
+        }
+        //construct new element in new storage while the old one is still intact, then move the others over
+        DARRINT s = DARR_SIZE(p);
+        T* q = allocate(growth(DARR_CAPA(p), s+1), DARR_RAW(p).allo);
+        try {
+            ::new((void*)(q+s)) T(std::forward<A>(args)...);
+        } catch (...) {
+            dynarrFree(q);
+            throw;
+        }
+        try {
+            transfer(q);
+        } catch (...) {
+            (q+s)->~T();
+            dynarrFree(q);
+            throw;
+        }
+        dynarrFree(p);
+        p = q;
+        DARR_SIZE(p)++;
+        return p[s];
+    }
+};
+
+//comparison and swap
+template <class T> bool operator== (const dynarray<T>& a, const dynarray<T>& b) {
+    if (a.size() != b.size()) return false;
+    for (DARRINT i = 0; i < a.size(); i++)
+        if (!(a.begin()[i] == b.begin()[i])) return false;
+    return true;
+}
+template <class T> bool operator!= (const dynarray<T>& a, const dynarray<T>& b) {
+    return !(a == b);
+}
+template <class T> void swap (dynarray<T>& a, dynarray<T>& b) noexcept {
+    a.swap(b);
+}
+
+#endif //DYNARR_HPP